@@ -0,0 +1,374 @@
+//=============================================================================//
+/*! @file
+    @brief  utils::format クラス・性能回帰検査 @n
+			・変換モード、出力ファンクタ毎に、固定の負荷を実行して ns/op を計測 @n
+			・変換で発生したヒープ確保（バイト数/op）を計測 @n
+			・基準ファイルと比較し、許容値を超えた場合に失敗（戻り値 1）を返す @n
+			-list                   計測結果を基準ファイル形式で出力（-check の基準の許容値を引き継ぎ、差分を表示） @n
+			-check file             基準ファイルと比較（超えた項目は、計測し直して判定） @n
+			-text size              テストバイナリの text サイズ（比較対象に追加）
+    @author 平松邦仁 (hira@rvf-rc45.net)
+	@copyright	Copyright (C) 2026 Kunihito Hiramatsu @n
+				Released under the MIT license @n
+				https://github.com/hirakuni45/RX/blob/master/LICENSE
+*/
+//=============================================================================//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <new>
+#include <array>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 文字列のエスケープ（%js、%vs）を検査する
+#define USE_ESCAPE_FORM
+#include "format.hpp"
+
+namespace {
+
+	// ヒープ確保の計測
+	size_t alloc_bytes_ = 0;
+
+	char buff_[512];
+
+	const uint8_t dump_[64] = { 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x00, 0x7f, 0xff };
+
+	const float real_a_ = sqrtf(2.0f);
+	const float real_b_ = sqrtf(5.0f);
+
+	// ユーザー型（ADL で見つかる format_value）
+	struct vec3 {
+		int	x;
+		int	y;
+		int	z;
+	};
+
+	template <class CTX>
+	void format_value(CTX& ctx, const vec3& v)
+	{
+		ctx.format("(%d, %d, %d)") % v.x % v.y % v.z;
+	}
+
+	const vec3 vec3_ = { 12, -345, 6789 };
+
+	const std::array<int, 8> range_ = { 1, -22, 333, -4444, 55555, -666666, 7777777, -88888888 };
+
+	const timespec time_ = { 1700000000, 123456789 };
+
+	// JSON に埋め込む文字列（エスケープの無い長い部分と、エスケープが必要な文字）
+	const char json_[] = "sensor \"temp-01\" reading within nominal range\tC:\\data\\log\n";
+
+	typedef void (*bench_func)(uint32_t loop);
+
+	struct bench_t {
+		const char*	name;
+		uint32_t	loop;
+		bench_func	func;
+	};
+
+	// 変換モード毎（sformat）
+	template <typename T>
+	void sformat_(const char* form, T val, uint32_t loop)
+	{
+		for(uint32_t i = 0; i < loop; ++i) {
+			utils::sformat(form, buff_, sizeof(buff_)) % val;
+		}
+	}
+
+	// 出力ファンクタ毎（混合フォーマット）
+	static constexpr char mix_form_[] = "%11.10f:%04d:%+g:%s:%p:%c:%%\n";
+
+	template <class FMT>
+	void mix_(uint32_t loop)
+	{
+		for(uint32_t i = 0; i < loop; ++i) {
+			FMT(mix_form_) % real_a_ % 42 % real_b_ % "str" % (void*)1000 % (int)'X';
+		}
+	}
+
+	void mix_sformat_(uint32_t loop)
+	{
+		for(uint32_t i = 0; i < loop; ++i) {
+			utils::sformat(mix_form_, buff_, sizeof(buff_))
+				% real_a_ % 42 % real_b_ % "str" % (void*)1000 % (int)'X';
+		}
+	}
+
+	// 分配（memory_chaout、size_chaout）：一度の変換で両方へ出力
+	typedef utils::basic_format<utils::tee_chaout<utils::memory_chaout, utils::size_chaout> > tee_format;
+
+	void mix_tee_(uint32_t loop)
+	{
+		auto& ch = tee_format::chaout();
+		ch.at<0>().set(buff_, sizeof(buff_));
+		for(uint32_t i = 0; i < loop; ++i) {
+			ch.clear();
+			tee_format(mix_form_) % real_a_ % 42 % real_b_ % "str" % (void*)1000 % (int)'X';
+		}
+	}
+
+	// 実行時に無効なログ出力（引数の評価、変換を行わない）
+	void log_off_(uint32_t loop)
+	{
+		utils::set_log_level(utils::log_level::error);
+		for(uint32_t i = 0; i < loop; ++i) {
+			FORMAT_LOG_WITH(utils::sformat, utils::log_level::debug, mix_form_, buff_, sizeof(buff_))
+				% real_a_ % 42 % real_b_ % "str" % (void*)1000 % (int)'X';
+		}
+		utils::set_log_level(utils::log_level::trace);
+	}
+
+	const bench_t bench_[] = {
+		{ "mode_c",       100000, [](uint32_t n) { sformat_("%c", 'X', n); } },
+		{ "mode_s",       100000, [](uint32_t n) { sformat_("%s", "AbcdEFG", n); } },
+		{ "mode_s_width", 100000, [](uint32_t n) { sformat_("%12s", "AbcdEFG", n); } },
+		{ "mode_b",       100000, [](uint32_t n) { sformat_("%b", 0xa5a5a5a5u, n); } },
+		{ "mode_b64",      50000, [](uint32_t n) { sformat_("%b", 0xa5a5a5a5a5a5ull, n); } },
+		{ "mode_o",       100000, [](uint32_t n) { sformat_("%o", 01245667u, n); } },
+		{ "mode_d",       100000, [](uint32_t n) { sformat_("%d", -12345678, n); } },
+		{ "mode_d_zero",  100000, [](uint32_t n) { sformat_("%012d", -12345678, n); } },
+		{ "mode_d64",      50000, [](uint32_t n) { sformat_("%d", -0x86567f12a4bf9cll, n); } },
+		{ "mode_u",       100000, [](uint32_t n) { sformat_("%u", 12345678u, n); } },
+		{ "mode_x",       100000, [](uint32_t n) { sformat_("%x", 0x12a4bf9cu, n); } },
+		{ "mode_X",       100000, [](uint32_t n) { sformat_("%08X", 0x12a4bf9cu, n); } },
+		{ "mode_p",       100000, [](uint32_t n) { sformat_("%p", (void*)1000, n); } },
+		{ "mode_y",       100000, [](uint32_t n) { sformat_("%4.3:10y", 896, n); } },
+		{ "mode_f",        50000, [](uint32_t n) { sformat_("%9.8f", real_b_, n); } },
+		{ "mode_e",        50000, [](uint32_t n) { sformat_("%e", 102500.125f, n); } },
+		{ "mode_e_small",  50000, [](uint32_t n) { sformat_("%e", 0.0000000325f, n); } },
+		{ "mode_g",        50000, [](uint32_t n) { sformat_("%g", 1e5f * real_a_, n); } },
+		{ "mode_g_small",  50000, [](uint32_t n) { sformat_("%g", 1e-3f * real_a_, n); } },
+		{ "mode_a",        50000, [](uint32_t n) { sformat_("%a", 1e5 * real_a_, n); } },
+		{ "mode_js",       50000, [](uint32_t n) { sformat_("%js", json_, n); } },
+		{ "mode_m",        20000, [](uint32_t n) { sformat_("%m", utils::byte_span(dump_, sizeof(dump_)), n); } },
+		{ "mode_user",     50000, [](uint32_t n) { sformat_("%s", vec3_, n); } },
+		{ "mode_range",    20000, [](uint32_t n) { sformat_("%d", utils::join(range_, ","), n); } },
+		{ "mode_t",       100000, [](uint32_t n) { sformat_("%.3t", time_, n); } },
+		{ "sink_format",   50000, mix_<utils::format> },
+		{ "sink_nformat",   2000, mix_<utils::nformat> },
+		{ "sink_sformat",  50000, mix_sformat_ },
+		{ "sink_size",     50000, mix_<utils::size_format> },
+		{ "sink_null",     50000, mix_<utils::null_format> },
+		{ "sink_tee",      50000, mix_tee_ },
+		{ "log_off",     1000000, log_off_ },
+	};
+
+	static constexpr uint32_t bench_num_ = sizeof(bench_) / sizeof(bench_[0]);
+
+	static constexpr int repeat_ = 15;			///< 計測回数（最小値を採用）
+	static constexpr int retry_ = 2;			///< 許容値を超えた項目を計測し直す回数
+	static constexpr double slack_ns_ = 2.0;	///< ns/op の絶対許容値（計測誤差）
+	static constexpr int tol_ns_ = 15;			///< 基準に無い項目の許容値（%）
+	static constexpr int tol_text_ = 5;			///< 基準に無い text の許容値（%）
+
+	struct result_t {
+		double	ns;
+		double	bytes;
+	};
+
+	// 一回分の計測
+	result_t measure_(const bench_t& t)
+	{
+		result_t r;
+		auto org = alloc_bytes_;
+		auto st = std::chrono::steady_clock::now();
+		t.func(t.loop);
+		auto ed = std::chrono::steady_clock::now();
+		utils::format::flush();
+		r.ns = std::chrono::duration<double, std::nano>(ed - st).count() / t.loop;
+		r.bytes = static_cast<double>(alloc_bytes_ - org) / t.loop;
+		return r;
+	}
+
+	struct base_t {
+		char	name[32];
+		double	ns;
+		double	bytes;
+		double	tol;
+		bool	valid;
+	};
+
+	base_t base_[bench_num_ + 1];
+
+	int load_base_(const char* file)
+	{
+		auto fp = fopen(file, "r");
+		if(fp == nullptr) {
+			return -1;
+		}
+		int n = 0;
+		char line[256];
+		while(fgets(line, sizeof(line), fp) != nullptr && n < static_cast<int>(bench_num_ + 1)) {
+			if(line[0] == '#' || line[0] == '\n') continue;
+			auto& b = base_[n];
+			if(sscanf(line, "%31s %lf %lf %lf", b.name, &b.ns, &b.bytes, &b.tol) == 4) {
+				b.valid = true;
+				++n;
+			}
+		}
+		fclose(fp);
+		return n;
+	}
+
+	const base_t* find_base_(const char* name, int num)
+	{
+		for(int i = 0; i < num; ++i) {
+			if(strcmp(base_[i].name, name) == 0) return &base_[i];
+		}
+		return nullptr;
+	}
+
+	bool over_(const result_t& r, const base_t* b)
+	{
+		if(b == nullptr) return false;
+		return r.ns > (b->ns * (1.0 + b->tol / 100.0) + slack_ns_) || r.bytes > b->bytes;
+	}
+
+	// 基準との差分（基準を更新する場合、コミットに記す）
+	void delta_(const char* name, double org, double res, int prec = 2)
+	{
+		fprintf(stderr, "%-14s %9.*f -> %9.*f (%+6.1f%%)\n", name, prec, org, prec, res,
+			org > 0.0 ? (res - org) * 100.0 / org : 0.0);
+	}
+}
+
+void* operator new(size_t size)
+{
+	alloc_bytes_ += size;
+	auto p = malloc(size);
+	if(p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t size) noexcept { free(p); }
+
+int main(int argc, char* argv[]);
+
+int main(int argc, char* argv[])
+{
+	const char* check = nullptr;
+	bool list = false;
+	long text = -1;
+	for(int i = 1; i < argc; ++i) {
+		std::string s = argv[i];
+		if(s == "-list") {
+			list = true;
+		} else if(s == "-check" && (i + 1) < argc) {
+			check = argv[++i];
+		} else if(s == "-text" && (i + 1) < argc) {
+			text = std::atol(argv[++i]);
+		}
+	}
+	if(!list && check == nullptr) {
+		printf("Performance regression check for 'format class'\n");
+		printf("    -list          List results (baseline format, keeps the tolerances of -check)\n");
+		printf("    -check file    Compare with baseline file\n");
+		printf("    -text size     Code size (text) of test binary\n");
+		return 0;
+	}
+
+	int basen = 0;
+	if(check != nullptr) {
+		basen = load_base_(check);
+		if(basen < 0) {
+			fprintf(stderr, "Can't open baseline: '%s'\n", check);
+			return 1;
+		}
+	}
+
+	// 標準出力系の出力ファンクタは、/dev/null へ出力する
+	fflush(stdout);
+	auto org = dup(STDOUT_FILENO);
+#ifdef WIN32
+	auto nul = open("NUL", O_WRONLY);
+#else
+	auto nul = open("/dev/null", O_WRONLY);
+#endif
+	dup2(nul, STDOUT_FILENO);
+	close(nul);
+
+	// 一時的な負荷の影響を避ける為、全体を繰り返し、最小値を採用する
+	result_t res[bench_num_];
+	for(int n = 0; n < repeat_; ++n) {
+		for(uint32_t i = 0; i < bench_num_; ++i) {
+			auto r = measure_(bench_[i]);
+			if(n == 0 || r.ns < res[i].ns) res[i].ns = r.ns;
+			res[i].bytes = r.bytes;
+		}
+	}
+
+	// 許容値を超えた項目だけ計測し直す（許容値を狭くしても、負荷の偏りで失敗しない）
+	if(!list) {
+		for(int k = 0; k < retry_; ++k) {
+			bool retry = false;
+			for(uint32_t i = 0; i < bench_num_; ++i) {
+				if(!over_(res[i], find_base_(bench_[i].name, basen))) continue;
+				retry = true;
+				for(int n = 0; n < repeat_; ++n) {
+					auto r = measure_(bench_[i]);
+					if(r.ns < res[i].ns) res[i].ns = r.ns;
+					res[i].bytes = r.bytes;
+				}
+			}
+			if(!retry) break;
+		}
+	}
+
+	dup2(org, STDOUT_FILENO);
+	close(org);
+
+	if(list) {
+		printf("# name          ns/op     bytes/op  tolerance(%%)\n");
+		for(uint32_t i = 0; i < bench_num_; ++i) {
+			auto b = find_base_(bench_[i].name, basen);
+			printf("%-14s %9.2f %9.2f %3d\n", bench_[i].name, res[i].ns, res[i].bytes,
+				b != nullptr ? static_cast<int>(b->tol) : tol_ns_);
+			if(b != nullptr) delta_(bench_[i].name, b->ns, res[i].ns);
+		}
+		if(text >= 0) {
+			auto b = find_base_("text", basen);
+			printf("%-14s %9ld %9.2f %3d\n", "text", text, 0.0,
+				b != nullptr ? static_cast<int>(b->tol) : tol_text_);
+			if(b != nullptr) delta_("text", b->ns, static_cast<double>(text), 0);
+		}
+		return 0;
+	}
+
+	int fail = 0;
+	for(uint32_t i = 0; i < bench_num_; ++i) {
+		const auto& t = bench_[i];
+		auto b = find_base_(t.name, basen);
+		if(b == nullptr) {
+			printf("%-14s %9.2f ns %7.2f B  (no baseline)\n", t.name, res[i].ns, res[i].bytes);
+			continue;
+		}
+		bool ng = over_(res[i], b);
+		printf("%s%-14s %9.2f ns (%9.2f) %7.2f B (%7.2f)  %s\x1B[37;m\n",
+			ng ? "\x1B[31;1m" : "\x1B[32;1m",
+			t.name, res[i].ns, b->ns, res[i].bytes, b->bytes, ng ? "Regression." : "Pass.");
+		if(ng) ++fail;
+	}
+	if(text >= 0) {
+		auto b = find_base_("text", basen);
+		if(b != nullptr) {
+			bool ng = text > static_cast<long>(b->ns * (1.0 + b->tol / 100.0));
+			printf("%s%-14s %9ld B  (%9.0f)  %s\x1B[37;m\n",
+				ng ? "\x1B[31;1m" : "\x1B[32;1m",
+				"text", text, b->ns, ng ? "Regression." : "Pass.");
+			if(ng) ++fail;
+		}
+	}
+
+	if(fail > 0) {
+		printf("Regression for: %d\n", fail);
+		return 1;
+	}
+	printf("No regression.\n");
+	return 0;
+}
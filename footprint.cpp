@@ -0,0 +1,83 @@
+//=============================================================================//
+/*! @file
+    @brief  utils::format のコードサイズ（フットプリント）計測 @n
+			・代表的な呼び出しを、構成マクロ（NO_FLOAT_FORM 等）、出力ファンクタ、 @n
+			引数の型毎に -Os でコンパイルし、text/data/bss を計測する @n
+			・計測値は「footprint_budget.txt」と比較され、許容値を超えた場合失敗する @n
+			（make footprint / make footprint_check / make footprint_update） @n
+			・FP_SINK_xxx で出力ファンクタ、FP_ARG_xxx で引数の型を選択 @n
+			（FP_ARG_xxx が無い場合、全ての型を使う） @n
+			※変換モードは書式から実行時に選ぶので、同じ型の変換（%d、%x、%y など）は、 @n
+			どれか１つを使っても全て含まれる（型毎に計測する）。 @n
+			・FP_SINK_multi は、format、sformat、size_format を同じプログラムで使う場合
+    @author 平松邦仁 (hira@rvf-rc45.net)
+	@copyright	Copyright (C) 2026 Kunihito Hiramatsu @n
+				Released under the MIT license @n
+				https://github.com/hirakuni45/RX/blob/master/LICENSE
+*/
+//=============================================================================//
+#include "format.hpp"
+
+#if defined(FP_SINK_nformat)
+#define FP_FMT(form)	utils::nformat(form)
+#elif defined(FP_SINK_sformat)
+#define FP_FMT(form)	utils::sformat(form, buf, len)
+#elif defined(FP_SINK_size_format)
+#define FP_FMT(form)	utils::size_format(form)
+#else
+#define FP_FMT(form)	utils::format(form)
+#endif
+
+#if !defined(FP_ARG_none) && !defined(FP_ARG_int) && !defined(FP_ARG_str) && !defined(FP_ARG_ptr) \
+ && !defined(FP_ARG_real) && !defined(FP_ARG_dump) && !defined(FP_ARG_time)
+#define FP_ARG_all
+#endif
+
+void fp_site(char* buf, uint32_t len, int i, unsigned u, double d, const char* s, void* p);
+
+// fmt(form) で、出力ファンクタ毎の format を生成
+template <class FMT>
+static void fp_sites(FMT fmt, uint32_t len, int i, unsigned u, double d, const char* s, void* p)
+{
+#if defined(FP_ARG_none)
+	fmt("literal\n");
+#endif
+#if defined(FP_ARG_int) || defined(FP_ARG_all)
+	fmt("%c\n") % i;
+	fmt("%5d\n") % i;
+	fmt("%u\n") % u;
+	fmt("%08X\n") % u;
+	fmt("%o\n") % u;
+	fmt("%b\n") % u;
+	fmt("%4.2:8y\n") % i;
+#endif
+#if defined(FP_ARG_str) || defined(FP_ARG_all)
+	fmt("%-8s\n") % s;
+#endif
+#if defined(FP_ARG_ptr) || defined(FP_ARG_all)
+	fmt("%p\n") % p;
+#endif
+#if defined(FP_ARG_real) || defined(FP_ARG_all)
+	fmt("%7.3f\n") % d;
+	fmt("%e\n") % d;
+	fmt("%g\n") % d;
+#endif
+#if defined(FP_ARG_dump) || defined(FP_ARG_all)
+	fmt("%m\n") % utils::byte_span(p, len);
+#endif
+#if defined(FP_ARG_time) || defined(FP_ARG_all)
+	fmt("%t\n") % static_cast<time_t>(i);
+#endif
+}
+
+
+void fp_site(char* buf, uint32_t len, int i, unsigned u, double d, const char* s, void* p)
+{
+#if defined(FP_SINK_multi)
+	fp_sites([](const char* form) { return utils::format(form); }, len, i, u, d, s, p);
+	fp_sites([=](const char* form) { return utils::sformat(form, buf, len); }, len, i, u, d, s, p);
+	fp_sites([](const char* form) { return utils::size_format(form); }, len, i, u, d, s, p);
+#else
+	fp_sites([=](const char* form) { return FP_FMT(form); }, len, i, u, d, s, p);
+#endif
+}
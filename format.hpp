@@ -47,6 +47,33 @@
 			+ 2025/01/02 13:17- (v121) cleanup
 			+ 2025/03/27 12:19- (V122) %-0xxxd の場合の不具合修正
 			+ 2025/03/28 16:19- (V123) 二進表示の場合にバッファを利用しない
+			+ 2026/10/18 09:12- (V124) std::string_view 型追加、文字列の長さを再計算しない、%.Ns（最大文字数）をサポート
+			+ 2026/10/18 11:40- (V125) 出力ファンクタのブロック出力（write）、メモリーダンプ表示「%N.G:Lm」を追加
+			! 2026/10/18 15:05- (V126) %e、%g の正規化を整数演算（１０のべき乗テーブル）で行い、float 演算を排除 @n
+							%e の仮数が [1, 10) に収まらない不具合、1e16 以上、1e-11 以下の表示不具合修正 @n
+							%f の四捨五入で、ちょうど半分の値が切り捨てになる不具合修正
+			+ 2026/10/18 17:20- (V127) ユーザー型の変換（ADL の format_value、format_traits の特殊化）を追加
+			+ 2026/10/18 19:10- (V128) 範囲（begin、end を持つ型）の表示、join（区切り、括弧の指定）を追加
+			+ 2026/10/18 21:00- (V129) 時刻表示「%.Nt」（time_t、timespec、system_clock::time_point）を追加
+			+ 2026/10/19 09:30- (V130) 分配出力ファンクタ tee_chaout を追加、書式以外の文字列をブロック出力 @n
+							引数が多い場合、フォーマット式の終端を越えて参照する不具合修正
+			+ 2026/10/19 11:00- (V131) レベル付きのログ出力 FORMAT_LOG、FORMAT_LOG_WITH を追加
+			+ 2026/10/19 13:20- (V132) null_format を特殊化（解析、変換を行わず、コードを生成しない）
+			+ 2026/10/19 15:40- (V133) 出力先が溢れた場合 error::out_overflow を設定、中断、再開（resume_state）を追加 @n
+							バッファを指定するコンストラクターで、一部のメンバーが初期化されない不具合修正
+			+ 2026/10/19 16:30- (V134) memory_chaout で溢れた文字数を数え、required_size() で必要なサイズを返す @n
+							出力先が溢れた後も、変換を続ける（中断、再開する場合を除く、out_overflow は get_error で返す）
+			+ 2026/10/19 18:00- (V135) ノンブロッキングのファイル・ディスクリプタ出力 fd_ring_chaout を追加
+			+ 2026/10/19 19:10- (V136) フライト・レコーダー出力 recorder_chaout を追加
+			+ 2026/10/19 20:30- (V137) 定数式で変換する array_chaout、make_format を追加
+			+ 2026/10/19 21:40- (V138) %y の変換を、引数の幅で行う（8/16/32 ビット）、正の符号付きの値に「-」が付く問題を修正
+			+ 2026/10/19 23:00- (V139) バッファリング出力ファンクタのフラッシュ統計 flush_stat を追加
+			+ 2026/10/19 23:50- (V140) 変換の本体をテンプレートでは無い format_core に移動（出力ファンクタ毎の重複を削除）
+			+ 2026/10/20 00:40- (V141) シグナル・ハンドラー用 signal_format（signal_chaout）を追加
+			+ 2026/10/20 01:30- (V142) 128 ビット整数（__int128）の %d %u %x %X %o %b に対応
+			+ 2026/10/20 02:20- (V143) １６進浮動小数点（%a、%A）を追加
+			+ 2026/10/20 03:10- (V144) 文字列のエスケープ（%js、%vs）を追加
+			+ 2026/10/20 04:00- (V145) FILE、std::streambuf への出力（file_format、stream_format）を追加
     @author 平松邦仁 (hira@rvf-rc45.net)
 	@copyright	Copyright (C) 2013, 2025 Kunihito Hiramatsu @n
 				Released under the MIT license @n
@@ -54,10 +81,29 @@
 */
 //=============================================================================//
 #include <type_traits>
+#include <utility>
+#include <iterator>
+#include <tuple>
+#include <array>
+#include <limits>
 #include <unistd.h>
+#include <cerrno>
+#include <csignal>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <ctime>
+#include <cstdio>
+#ifndef NO_TIME_FORM
+#include <chrono>
+#endif
+#ifdef USE_STREAM_FORM
+#include <streambuf>
+#include <ostream>
+#endif
 
 // 最終的な出力として putchar を使う場合有効にする（通常は write [stdout] 関数）
 // #define USE_PUTCHAR
@@ -71,6 +117,74 @@
 // ８進表示をサポートしない場合（メモリの節約）
 // #define NO_OCTAL_FORM
 
+// メモリーダンプ表示をサポートしない場合（メモリの節約）
+// #define NO_DUMP_FORM
+
+// 時刻表示（%t）をサポートしない場合（メモリの節約、スレッドローカルを使わない）
+// #define NO_TIME_FORM
+
+// 文字列のエスケープ（%js、%vs）をサポートする場合（%s 毎にエスケープの処理が入るので、標準では無効）
+// #define USE_ESCAPE_FORM
+
+// std::streambuf への出力（streambuf_chaout、stream_format）をサポートする場合（<ostream> を含むので、標準では無効）
+// #define USE_STREAM_FORM
+
+// format（標準出力）のフラッシュ統計（flush_stat）を有効にする場合
+// #define FORMAT_FLUSH_STAT
+
+// 出力の中断、再開（resume_state）をサポートしない場合（メモリの節約、溢れの検出は行う）
+// #define NO_RESUME_FORM
+
+// 書式の解析を、出力ファンクタ毎に展開しないで共有する場合（コードサイズ優先、-Os では標準）
+// #define FORMAT_SHARED_CORE
+
+// 最適化をしない場合でも、インライン展開する（null_format の関数呼び出しを取り除く）
+#if defined(__GNUC__) || defined(__clang__)
+#define FORMAT_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define FORMAT_ALWAYS_INLINE __forceinline
+#else
+#define FORMAT_ALWAYS_INLINE inline
+#endif
+
+// インライン展開しない（出力先の溢れなど、稀な処理を呼び出し側から外す、-Os ではコンパイラに任せる）
+#if defined(__OPTIMIZE_SIZE__)
+#define FORMAT_NOINLINE
+#elif defined(__GNUC__) || defined(__clang__)
+#define FORMAT_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define FORMAT_NOINLINE __declspec(noinline)
+#else
+#define FORMAT_NOINLINE
+#endif
+
+// 変換コア（format_core）の書式の解析：速度優先の場合、出力ファンクタ毎に展開する
+#if defined(FORMAT_SHARED_CORE) || defined(__OPTIMIZE_SIZE__)
+#define FORMAT_CORE_INLINE
+#else
+#define FORMAT_CORE_INLINE FORMAT_ALWAYS_INLINE
+#endif
+
+// 空のメンバーに領域を割り当てない（C++20 の属性、GCC は C++17 でも受け付ける）
+#if (defined(__GNUC__) && !defined(__clang__)) || __cplusplus >= 202002L
+#define FORMAT_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#else
+#define FORMAT_NO_UNIQUE_ADDRESS
+#endif
+
+// 定数式で評価されている場合「true」（make_format で、文字列の長さをライブラリ関数を使わずに数える）
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define FORMAT_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define FORMAT_CONSTANT_EVALUATED() false
+#endif
+
+// ログ出力（FORMAT_LOG）の、コンパイル時のレベル（これより大きいレベルは、コードを生成しない）
+// 0: none, 1: error, 2: warn, 3: info, 4: debug, 5: trace
+#ifndef FORMAT_LOG_LEVEL
+#define FORMAT_LOG_LEVEL 5
+#endif
+
 /* 
   e, E
      double 引き数を丸めて [-]d.ddde±dd の形に変換する。 小数点の前には一桁の数字があり、
@@ -96,6 +210,10 @@
     変換される値の指数が、 -4 より小さいか、精度以上の場合に、 e 形式が使用される。
     変換された結果の小数部分の末尾の 0 は削除される。小数点が表示されるのは、 小数点以下に
     数字が少なくとも一つある場合にだけである。 
+
+  t
+    time_t、timespec、std::chrono::system_clock::time_point を、ローカル時刻
+    YYYY-MM-DD HH:MM:SS の形に変換する（拡張）。精度は秒以下の桁数（最大 9）を指定する。
 */
 
 namespace utils {
@@ -104,7 +222,7 @@ namespace utils {
 	/*!
 		@brief  無効出力ファンクタ @n
 				※全ての動作を無効にして、機能を取り除く。 @n
-				※最適化をしない場合、全てを取り除く事は出来ない。
+				※basic_format<null_chaout> は特殊化され、変換を一切行わない。
 	*/
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
 	struct null_chaout {
@@ -113,6 +231,8 @@ namespace utils {
 
 		void operator() (char ch) noexcept { }
 
+		void write(const char* s, uint n) noexcept { }
+
 		void clear() noexcept { };
 
 		uint size() const noexcept { return 0; }
@@ -144,6 +264,10 @@ namespace utils {
 			++size_;
 		}
 
+		void write(const char* s, uint n) noexcept {
+			size_ += n;
+		}
+
 		void clear() noexcept { size_ = 0; };
 
 		uint size() const noexcept { return size_; }
@@ -176,24 +300,208 @@ namespace utils {
 			putchar(ch);
 #else
 			char tmp = ch;
-			write(STDOUT_FILENO, &tmp, 1);
+			::write(STDOUT_FILENO, &tmp, 1);
 #endif
 			++size_;
 		}
 
+		void write(const char* s, uint n) noexcept
+		{
+#ifdef USE_PUTCHAR
+			for(uint i = 0; i < n; ++i) {
+				putchar(s[i]);
+			}
+#else
+			::write(STDOUT_FILENO, s, n);
+#endif
+			size_ += n;
+		}
+
 		void clear() noexcept { size_ = 0; };
 
 		uint size() const noexcept { return size_; }
 	};
 
 
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  フラッシュの要因
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	enum class flush_cause : uint8_t {
+		newline,	///< 改行
+		full,		///< バッファが一杯
+		request,	///< flush() の呼び出し
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  フラッシュ統計無し（バッファリング出力ファンクタの既定） @n
+				※全て空の関数なので、コードを生成しない。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct flush_stat_none {
+		static uint64_t now() noexcept { return 0; }
+		void flush(flush_cause cause, uint32_t n) noexcept { }
+		void write(uint64_t t, uint32_t n, long ret) noexcept { }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  フラッシュ統計（バッファリング出力ファンクタのテンプレート・パラメーター） @n
+				※フラッシュの回数（要因別）、フラッシュ毎の文字数（ヒストグラム）、 @n
+				write の回数、部分書き込み、失敗、write に掛かった時間を数える。 @n
+				※BFN（バッファサイズ）とフラッシュの方針を、実測で決める為に使う。 @n
+				※dump() で書き出し、dump_at_exit() で終了時に書き出す。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct flush_stat {
+
+		static constexpr uint32_t HIST_NUM = 16;	///< ヒストグラムの数
+
+		uint32_t	flushes;	///< フラッシュの回数
+		uint32_t	newline;	///< 改行によるフラッシュ
+		uint32_t	full;		///< バッファが一杯によるフラッシュ
+		uint32_t	request;	///< flush() によるフラッシュ
+		uint32_t	writes;		///< write の回数
+		uint32_t	shorts;		///< 要求より少なく書き込めた write の回数
+		uint32_t	errors;		///< 失敗した write の回数（EAGAIN、EINTR を含む）
+		uint64_t	bytes;		///< 書き込めた文字数
+		uint64_t	write_ns;	///< write に掛かった時間 [ns]
+		uint32_t	hist[HIST_NUM];	///< フラッシュ毎の文字数（hist[i] は 2^i 以上 2^(i+1) 未満、最後は 2^i 以上）
+
+	private:
+		flush_stat*	exit_next_;
+		int			exit_fd_;
+
+		static inline flush_stat*	exit_list_ = nullptr;
+
+		static void exit_dump_() noexcept
+		{
+			for(auto p = exit_list_; p != nullptr; p = p->exit_next_) {
+				p->dump(p->exit_fd_);
+			}
+		}
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+		*/
+		//-----------------------------------------------------------------//
+		flush_stat() noexcept : exit_next_(nullptr), exit_fd_(-1) { reset(); }
+
+
+		/// 全ての値をクリア
+		void reset() noexcept {
+			flushes = 0;
+			newline = 0;
+			full = 0;
+			request = 0;
+			writes = 0;
+			shorts = 0;
+			errors = 0;
+			bytes = 0;
+			write_ns = 0;
+			for(uint32_t i = 0; i < HIST_NUM; ++i) hist[i] = 0;
+		}
+
+
+		/// 時間 [ns]（CLOCK_MONOTONIC）
+		static uint64_t now() noexcept {
+			timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  フラッシュを数える（出力ファンクタから呼ばれる）
+			@param[in]	cause	要因
+			@param[in]	n		書き込み待ちの文字数
+		*/
+		//-----------------------------------------------------------------//
+		void flush(flush_cause cause, uint32_t n) noexcept {
+			++flushes;
+			switch(cause) {
+			case flush_cause::newline:
+				++newline;
+				break;
+			case flush_cause::full:
+				++full;
+				break;
+			default:
+				++request;
+				break;
+			}
+			uint32_t i = 0;
+			while(i < (HIST_NUM - 1) && (n >> (i + 1)) != 0) ++i;
+			++hist[i];
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  write を数える（出力ファンクタから呼ばれる）
+			@param[in]	t		write を呼ぶ前の now()
+			@param[in]	n		要求した文字数
+			@param[in]	ret		write の戻り値
+		*/
+		//-----------------------------------------------------------------//
+		void write(uint64_t t, uint32_t n, long ret) noexcept {
+			write_ns += now() - t;
+			++writes;
+			if(ret < 0) {
+				++errors;
+			} else {
+				bytes += static_cast<uint64_t>(ret);
+				if(static_cast<uint64_t>(ret) < n) ++shorts;
+			}
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  統計を書き出す（format.hpp の最後で定義）
+			@param[in]	fd	ファイル・ディスクリプタ（通常 STDERR_FILENO）
+		*/
+		//-----------------------------------------------------------------//
+		void dump(int fd) const noexcept;
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  終了時（exit、main から戻る）に書き出す @n
+					※登録した順に書き出す。同じ統計を２回登録しない事。
+			@param[in]	fd	ファイル・ディスクリプタ（通常 STDERR_FILENO）
+		*/
+		//-----------------------------------------------------------------//
+		void dump_at_exit(int fd) noexcept
+		{
+			exit_fd_ = fd;
+			if(exit_list_ == nullptr) {
+				std::atexit(exit_dump_);
+				exit_list_ = this;
+			} else {
+				auto p = exit_list_;
+				while(p->exit_next_ != nullptr) p = p->exit_next_;
+				p->exit_next_ = this;
+			}
+		}
+	};
+
+
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
 	/*!
 		@brief  標準出力バッファリングファンクタ
 		@param[in]	BFN		バッファサイズ
+		@param[in]	STAT	フラッシュ統計（flush_stat で有効）
 	*/
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
-	template <uint32_t BFN>
+	template <uint32_t BFN, class STAT = flush_stat_none>
 	struct stdout_buffered_chaout {
 
 		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
@@ -202,6 +510,25 @@ namespace utils {
 		char	buff_[BFN];
 		uint	pos_;
 		uint	size_;
+		FORMAT_NO_UNIQUE_ADDRESS STAT	stat_;
+
+		void flush_(flush_cause cause) noexcept
+		{
+			if(pos_ == 0) return;
+
+			stat_.flush(cause, pos_);
+			auto t = stat_.now();
+#ifdef USE_PUTCHAR
+			for(uint i = 0; i < pos_; ++i) {
+				putchar(buff_[i]);
+			}
+			stat_.write(t, pos_, pos_);
+#else
+			auto ret = ::write(STDOUT_FILENO, buff_, pos_);
+			stat_.write(t, pos_, ret);
+#endif
+			pos_ = 0;
+		}
 
 	public:
 		//-----------------------------------------------------------------//
@@ -215,30 +542,267 @@ namespace utils {
 			buff_[pos_] = ch;
 			++pos_;
 			if(ch == '\n' || pos_ >= BFN) {
-				flush();
+				flush_(ch == '\n' ? flush_cause::newline : flush_cause::full);
 			}
 			++size_;
 		}
 
+		// 改行、バッファが一杯でフラッシュする動作は、１文字出力と同じ
+		void write(const char* s, uint n) noexcept {
+			size_ += n;
+			while(n > 0) {
+				uint l = BFN - pos_;
+				if(l > n) l = n;
+				auto nl = static_cast<const char*>(std::memchr(s, '\n', l));
+				if(nl != nullptr) {
+					l = nl - s + 1;
+				}
+				for(uint i = 0; i < l; ++i) {
+					buff_[pos_ + i] = s[i];
+				}
+				pos_ += l;
+				s += l;
+				n -= l;
+				if(nl != nullptr || pos_ >= BFN) {
+					flush_(nl != nullptr ? flush_cause::newline : flush_cause::full);
+				}
+			}
+		}
+
 		void clear() noexcept { size_ = 0; };
 
 		auto size() const noexcept { return size_; }
 
 		auto pos() const noexcept { return pos_; }
 
-		void flush() noexcept
+		void flush() noexcept { flush_(flush_cause::request); }
+
+		/// フラッシュ統計
+		const STAT& stat() const noexcept { return stat_; }
+
+		/// フラッシュ統計（reset、dump_at_exit 用）
+		STAT& stat() noexcept { return stat_; }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  ファイル・ディスクリプタ、リング・バッファ出力ファンクタ @n
+				※ノンブロッキングのパイプ、ソケット用で、EAGAIN で待たない。 @n
+				※書き込めた分だけ書き込み、残りはリング・バッファに保持する。 @n
+				※改行、バッファが一杯で書き込みを試みる。残りは、イベント・ループ（epoll 等）が @n
+				wants_write() の間、書き込み可能になったら flush() を呼ぶ。 @n
+				※バッファに入らない文字は捨て、捨てた文字数を lost() で返す（overflow）。 @n
+				※構築後、メモリを確保しない。
+		@param[in]	BFN		バッファサイズ（２のべき乗）
+		@param[in]	STAT	フラッシュ統計（flush_stat で有効）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <uint32_t BFN, class STAT = flush_stat_none>
+	struct fd_ring_chaout {
+
+		static_assert(BFN >= 2 && (BFN & (BFN - 1)) == 0, "utils::fd_ring_chaout: BFN must be a power of 2");
+
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+		/// 水位の通知（high: 上限に達した場合「true」、下限まで減った場合「false」）
+		typedef void (*mark_func)(bool high, void* ctx);
+
+	private:
+		char		buff_[BFN];
+		uint		head_;	///< 格納位置（フリーラン）
+		uint		tail_;	///< 書き込み位置（フリーラン）
+		uint		size_;
+		uint		lost_;
+		int			fd_;
+		int			errno_;
+		uint		high_;
+		uint		low_;
+		mark_func	mark_;
+		void*		ctx_;
+		bool		above_;
+		FORMAT_NO_UNIQUE_ADDRESS STAT	stat_;
+
+		void mark_high_() noexcept {
+			if(mark_ != nullptr && !above_ && pending() >= high_) {
+				above_ = true;
+				mark_(true, ctx_);
+			}
+		}
+
+		void mark_low_() noexcept {
+			if(above_ && pending() <= low_) {
+				above_ = false;
+				mark_(false, ctx_);
+			}
+		}
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+		*/
+		//-----------------------------------------------------------------//
+		fd_ring_chaout() noexcept : head_(0), tail_(0), size_(0), lost_(0), fd_(-1), errno_(0),
+			high_(0), low_(0), mark_(nullptr), ctx_(nullptr), above_(false) { }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  出力先を設定（バッファに残っている文字は捨てない）
+			@param[in]	fd	ファイル・ディスクリプタ（ノンブロッキング）
+		*/
+		//-----------------------------------------------------------------//
+		void set(int fd) noexcept
 		{
-			if(pos_ == 0) return;
+			fd_ = fd;
+			errno_ = 0;
+		}
 
-#ifdef USE_PUTCHAR
-			for(uint i = 0; i < pos_; ++i) {
-				putchar(buff_[i]);
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  水位の通知を設定 @n
+					※残りが high 以上になった時 mark(true)、low 以下に戻った時 mark(false) を呼ぶ。
+			@param[in]	high	上限
+			@param[in]	low		下限
+			@param[in]	mark	通知関数（nullptr で解除）
+			@param[in]	ctx		通知関数に渡すポインター
+		*/
+		//-----------------------------------------------------------------//
+		void set_mark(uint high, uint low, mark_func mark, void* ctx = nullptr) noexcept
+		{
+			high_ = high;
+			low_ = low;
+			mark_ = mark;
+			ctx_ = ctx;
+			above_ = false;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		void operator () (char ch) noexcept {
+			if(pending() >= BFN) {
+				flush_(flush_cause::full);
+				if(pending() >= BFN) {
+					++lost_;
+					return;
+				}
 			}
-#else
-			write(STDOUT_FILENO, buff_, pos_);
-#endif
-			pos_ = 0;
+			buff_[head_ & (BFN - 1)] = ch;
+			++head_;
+			++size_;
+			if(ch == '\n') {
+				flush_(flush_cause::newline);
+			}
+			mark_high_();
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ブロック出力（入らない分は捨てる）
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
+		*/
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept {
+			if(n > space()) {
+				flush_(flush_cause::full);
+				if(n > space()) {
+					lost_ += n - space();
+					n = space();
+				}
+			}
+			auto nl = std::memchr(s, '\n', n) != nullptr;
+			auto ofs = head_ & (BFN - 1);
+			auto l = BFN - ofs;
+			if(l > n) l = n;
+			std::memcpy(&buff_[ofs], s, l);
+			std::memcpy(&buff_[0], s + l, n - l);
+			head_ += n;
+			size_ += n;
+			if(nl) {
+				flush_(flush_cause::newline);
+			}
+			mark_high_();
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  書き込める分だけ書き込む（EAGAIN で止める）
+		*/
+		//-----------------------------------------------------------------//
+		void flush() noexcept { flush_(flush_cause::request); }
+
+	private:
+		void flush_(flush_cause cause) noexcept
+		{
+			if(fd_ >= 0 && tail_ != head_) {
+				stat_.flush(cause, pending());
+			}
+			while(fd_ >= 0 && tail_ != head_) {
+				auto ofs = tail_ & (BFN - 1);
+				uint len = head_ - tail_;
+				if(len > (BFN - ofs)) len = BFN - ofs;
+				auto t = stat_.now();
+				auto ret = ::write(fd_, &buff_[ofs], len);
+				stat_.write(t, len, ret);
+				if(ret < 0) {
+					if(errno == EINTR) continue;
+					if(errno != EAGAIN && errno != EWOULDBLOCK) {
+						errno_ = errno;
+					}
+					break;
+				}
+				tail_ += static_cast<uint>(ret);
+				if(static_cast<uint>(ret) < len) {
+					break;
+				}
+			}
+			mark_low_();
 		}
+
+	public:
+
+		/// 出力した文字数、捨てた文字数をクリア（バッファに残っている文字は捨てない）
+		void clear() noexcept { size_ = 0; lost_ = 0; }
+
+		/// 出力した（バッファに入れた）文字数
+		auto size() const noexcept { return size_; }
+
+		/// 書き込み待ちの文字数
+		uint pending() const noexcept { return head_ - tail_; }
+
+		/// バッファの空き
+		uint space() const noexcept { return BFN - pending(); }
+
+		/// 書き込み待ちが有る場合「true」（イベント・ループで、書き込み可能を待つ）
+		bool wants_write() const noexcept { return head_ != tail_; }
+
+		/// バッファが一杯で、捨てた文字数（clear() まで累積、format は構築時からの増分を式のエラーにする）
+		auto lost() const noexcept { return lost_; }
+
+		/// 文字を捨てた場合「true」（clear() まで累積）
+		bool overflow() const noexcept { return lost_ != 0; }
+
+		/// 書き込みエラー（EAGAIN 以外の errno、無い場合０）
+		int error() const noexcept { return errno_; }
+
+		/// ファイル・ディスクリプタ
+		int fd() const noexcept { return fd_; }
+
+		/// フラッシュ統計
+		const STAT& stat() const noexcept { return stat_; }
+
+		/// フラッシュ統計（reset、dump_at_exit 用）
+		STAT& stat() noexcept { return stat_; }
 	};
 
 
@@ -335,7 +899,8 @@ namespace utils {
 
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
 	/*!
-		@brief  メモリー出力文字列クラス
+		@brief  メモリー出力文字列クラス @n
+				※溢れた文字は捨てるが、その数は数え、全体に必要な文字数を返す。
 	*/
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
 	struct memory_chaout {
@@ -346,6 +911,9 @@ namespace utils {
 		char*	dst_;
 		uint	limit_;
 		uint	pos_;
+		uint	skip_;
+		uint	real_;	///< 文字を捨てる間の、本来の limit_（捨てる間は limit_ == pos_）
+		uint	drop_;	///< 溢れて捨てた文字数
 
 	public:
 		//-----------------------------------------------------------------//
@@ -353,7 +921,7 @@ namespace utils {
 			@brief  コンストラクター
 		*/
 		//-----------------------------------------------------------------//
-		memory_chaout() noexcept : dst_(nullptr), limit_(0), pos_(0) { }
+		memory_chaout() noexcept : dst_(nullptr), limit_(0), pos_(0), skip_(0), real_(0), drop_(0) { }
 
 
 		bool set(char* dst, uint limit) noexcept
@@ -362,10 +930,14 @@ namespace utils {
 				return false;
 			}
 			limit--;
+#ifndef NO_RESUME_FORM
+			skip(0);
+#endif
 
 			// ポインター、サイズ、どちらか異なる場合は常にリセット
 			if(dst_ != dst || limit_ != limit) {
 				pos_ = 0;
+				drop_ = 0;
 			}
 			dst_ = dst;
 			limit_ = limit;
@@ -380,287 +952,2687 @@ namespace utils {
 			@param[in]	ch	出力文字
 		*/
 		//-----------------------------------------------------------------//
-		void operator () (char ch) noexcept {
+		FORMAT_CORE_INLINE void operator () (char ch) noexcept {
 			if(pos_ < limit_) {
 				dst_[pos_] = ch;
 				++pos_;
 				dst_[pos_] = 0;
+			} else {
+				put_over_();
 			}
 		}
 
-		void clear() noexcept { pos_ = 0; }
 
-		auto size() const noexcept { return pos_; }
-	};
-
-
-	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
-	/*!
-		@brief	format 基本クラス定義
-	*/
-	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
-	struct base_format {
-
-		static constexpr uint16_t VERSION = 123;		///< バージョン番号（整数）
-
-		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		//-----------------------------------------------------------------//
 		/*!
-			@brief  エラー種別
+			@brief  ブロック出力
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
 		*/
-		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
-		enum class error : uint8_t {
-			none,			///< エラー無し
-			null,			///< 無効なポインター
-			unknown,		///< 不明な「型」
-			different,		///< 異なる「型」
-			over,			///< 数値の領域外（%c で char が扱える数値以外）
-			out_null,		///< 文字出力先が無効
-			out_overflow,	///< 文字出力先がオーバーフローした場合
-		};
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept {
+			if(n > (limit_ - pos_)) {
+				write_over_(s, n);
+				return;
+			}
+			copy_(s, n);
+		}
+
+	private:
+		// 入り切らない場合（文字を捨てる）
+		FORMAT_NOINLINE void put_over_() noexcept {
+#ifndef NO_RESUME_FORM
+			if(skip_ > 0) {
+				if(--skip_ == 0) {
+					limit_ = real_;
+				}
+				return;
+			}
+#endif
+			++drop_;
+		}
+
+		static void copy8_(char* d, const char* s) noexcept {
+			uint64_t w;
+			std::memcpy(&w, s, 8);
+			std::memcpy(d, &w, 8);
+		}
+
+		static void copy4_(char* d, const char* s) noexcept {
+			uint32_t w;
+			std::memcpy(&w, s, 4);
+			std::memcpy(d, &w, 4);
+		}
+
+		void copy_(const char* s, uint n) noexcept {
+			if(n > 0) {
+				// 数値変換などの短い文字列が殆どなので、memcpy（関数呼び出し）は使わず、８（４）バイト単位で転送
+				auto p = &dst_[pos_];
+				if(n >= 8) {  // 端数は、最後の８バイトを重ねて転送
+					uint i = 0;
+					for(; (i + 8) < n; i += 8) {
+						copy8_(&p[i], &s[i]);
+					}
+					copy8_(&p[n - 8], &s[n - 8]);
+				} else if(n >= 4) {
+					copy4_(p, s);
+					copy4_(&p[n - 4], &s[n - 4]);
+				} else {
+					for(uint i = 0; i < n; ++i) {
+						p[i] = s[i];
+					}
+				}
+				pos_ += n;
+				dst_[pos_] = 0;
+			}
+		}
+
+		// 入り切らない場合（捨てる文字を除き、入る分だけ出力）
+		void write_over_(const char* s, uint n) noexcept {
+#ifndef NO_RESUME_FORM
+			if(skip_ > 0) {
+				auto k = n < skip_ ? n : skip_;
+				skip_ -= k;
+				if(skip_ > 0) {
+					return;
+				}
+				limit_ = real_;
+				s += k;
+				n -= k;
+				if(n <= (limit_ - pos_)) {
+					copy_(s, n);
+					return;
+				}
+			}
+#endif
+			drop_ += n - (limit_ - pos_);
+			copy_(s, limit_ - pos_);
+		}
+
+	public:
+		void clear() noexcept {
+#ifndef NO_RESUME_FORM
+			skip(0);
+#endif
+			pos_ = 0;
+			drop_ = 0;
+		}
+
+		auto size() const noexcept { return pos_; }
+
+		/// 全て出力するのに必要な文字数（終端の０を含まない）
+		auto required_size() const noexcept { return pos_ + drop_; }
+
+		/// 出力先が溢れて、捨てた文字数
+		auto lost() const noexcept { return drop_; }
+
+		/// 出力先が溢れて、文字を捨てた場合「true」
+		bool overflow() const noexcept { return drop_ != 0; }
+
+#ifndef NO_RESUME_FORM
+		/// 次の n 文字を捨てる（中断した出力の再開で、出力済みの文字を飛ばす）
+		void skip(uint n) noexcept {
+			if(skip_ > 0) {
+				limit_ = real_;
+			}
+			skip_ = n;
+			if(n > 0) {
+				real_ = limit_;
+				limit_ = pos_;
+			}
+		}
+#endif
 	};
 
 
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
 	/*!
-		@brief  簡易 format クラス
-		@param[in]	CHAOUT	文字出力ファンクタ
+		@brief  フライト・レコーダー（リング・バッファ）出力ファンクタ @n
+				※最後の BFN 文字を保持し、古い文字から上書きする（システム・コールを使わない）。 @n
+				※dump() でファイル・ディスクリプタに書き出す（完全な行から始める）。 @n
+				※dump_on_signal() で、致命的なシグナル（assert の abort を含む）の時に書き出す。
+		@param[in]	BFN		バッファサイズ（２のべき乗）
 	*/
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
-	template <class CHAOUT>
-	class basic_format : public base_format {
+	template <uint32_t BFN>
+	struct recorder_chaout {
 
-		enum class mode : uint8_t {
-			CHA,			///< 文字
-			STR,			///< 文字列
-			BINARY,			///< ２進
-			OCTAL,			///< ８進
-			DECIMAL,		///< １０進
-			U_DECIMAL,		///< １０進（符号無し）
-			HEX_CAPS,		///< １６進（大文字）
-			HEX,			///< １６進（小文字）
-			POINTER,		///< ポインター（１６進）
-			FIXED_REAL,		///< 固定小数点
-			REAL,			///< 浮動小数点
-			EXPONENT_CAPS,	///< 浮動小数点 exp 形式(E)
-			EXPONENT,		///< 浮動小数点 exp 形式(e)
-			REAL_AUTO_CAPS,	///< 浮動小数点自動(G)
-			REAL_AUTO,		///< 浮動小数点自動(g)
-			NONE			///< 不明
-		};
+		static_assert(BFN >= 2 && (BFN & (BFN - 1)) == 0, "utils::recorder_chaout: BFN must be a power of 2");
 
-		static CHAOUT	chaout_;
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
 
-		const char*	form_;
+	private:
+		char	buff_[BFN];
+		uint	pos_;
+		bool	full_;	///< 一周した場合「true」
 
-		// ８進表示に必要な文字数＋サイン＋ターミネーター（１０進表示は２０桁必要）
-		// ※２進表示は、バッファを使わない
-		char		buff_[22 + 1 + 1];
+		static inline recorder_chaout*	sig_rec_ = nullptr;
+		static inline int				sig_fd_ = -1;
 
-		uint16_t	num_;
-		uint8_t		point_;
-		uint8_t		bitlen_;
-		uint8_t		udec_num_;
+		static void write_all_(int fd, const char* s, uint n) noexcept
+		{
+			while(n > 0) {
+				auto ret = ::write(fd, s, n);
+				if(ret < 0) {
+					if(errno == EINTR) continue;
+					break;
+				}
+				s += ret;
+				n -= static_cast<uint>(ret);
+			}
+		}
 
-		error		error_;
-		mode		mode_;
-		bool		zerosupp_;
-		bool		sign_;
-		bool		nega_;
-		bool		set_num_;
-		bool		set_poi_;
-		bool		auto_mode_;
-		bool		exp_mode_;
+		static void signal_(int sig) noexcept
+		{
+			if(sig_rec_ != nullptr) {
+				sig_rec_->dump(sig_fd_);
+			}
+			std::signal(sig, SIG_DFL);
+			std::raise(sig);
+		}
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+		*/
+		//-----------------------------------------------------------------//
+		recorder_chaout() noexcept : pos_(0), full_(false) { }
 
-		void str_(const char* str) noexcept {
-			char ch;
-			while((ch = *str++) != 0) chaout_(ch);
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		void operator () (char ch) noexcept {
+			buff_[pos_] = ch;
+			++pos_;
+			if(pos_ >= BFN) {
+				pos_ = 0;
+				full_ = true;
+			}
 		}
 
-		void reset_() noexcept {
-			num_ = 0;
-			point_ = 0;
-			bitlen_ = 0;
-			udec_num_ = 0;
-			mode_ = mode::NONE;
-			zerosupp_ = false;
-			sign_ = false;
-			nega_ = false;
-			set_num_ = false;
-			set_poi_ = false;
-			auto_mode_ = false;
-			exp_mode_ = false;
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ブロック出力（BFN を超える場合、最後の BFN 文字）
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
+		*/
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept {
+			if(n > BFN) {
+				s += n - BFN;
+				n = BFN;
+			}
+			auto l = BFN - pos_;
+			if(n < l) {
+				std::memcpy(&buff_[pos_], s, n);
+				pos_ += n;
+			} else {
+				std::memcpy(&buff_[pos_], s, l);
+				std::memcpy(&buff_[0], s + l, n - l);
+				pos_ = n - l;
+				full_ = true;
+			}
 		}
 
-		void next_() noexcept {
-			enum class apmd : uint8_t {
-				none,
-				num,	// 数字
-				point,	// 小数点
-				bitlen	// 固定小数点、ビット長さ
-			};
 
-			if(form_ == nullptr) {
-				error_ = error::null;
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  保持している文字を書き出す @n
+					※一周している場合、最初の改行の次（完全な行）から書き出す。 @n
+					※シグナル・ハンドラーから呼べる（write のみ使う）。
+			@param[in]	fd	ファイル・ディスクリプタ
+		*/
+		//-----------------------------------------------------------------//
+		void dump(int fd) const noexcept
+		{
+			if(!full_) {
+				write_all_(fd, buff_, pos_);
 				return;
 			}
-			auto md = apmd::none;
-			char ch;
-			while((ch = *form_++) != 0) {
-				if(md != apmd::none) {
-					switch(ch) {
-					case '+':
-						sign_ = true;
-						break;
-					case '-':
-						nega_ = true;
-						break;
-					case '0':
-					case '1':
-					case '2':
-					case '3':
-					case '4':
-					case '5':
-					case '6':
-					case '7':
-					case '8':
-					case '9':
-						ch -= '0';
-						if(md == apmd::num) {
-							if(num_ == 0 && ch == 0) {
-								zerosupp_ = true;
-							}
-							num_ *= 10;
-							num_ += static_cast<uint8_t>(ch);
-							set_num_ = true;
-						} else if(md == apmd::point) {
-							point_ *= 10;
-							point_ += static_cast<uint8_t>(ch);
-							set_poi_ = true;
-						} else if(md == apmd::bitlen) {
-							bitlen_ *= 10;
-							bitlen_ += static_cast<uint8_t>(ch);
-						}
-						break;
-					case '.':
-						md = apmd::point;
-						break;
-					case ':':
-						md = apmd::bitlen;
-						break;
-					case 's':
-						mode_ = mode::STR;
-						return;
-					case 'c':
-						mode_ = mode::CHA;
-						return;
-#ifndef NO_BIN_FORM
-					case 'b':
-						mode_ = mode::BINARY;
-						return;
-#endif
-#ifndef NO_OCTAL_FORM
-					case 'o':
-						mode_ = mode::OCTAL;
-						return;
+			auto org = pos_;
+			auto nl = static_cast<const char*>(std::memchr(&buff_[pos_], '\n', BFN - pos_));
+			if(nl != nullptr) {
+				org = nl - buff_ + 1;
+			} else {
+				nl = static_cast<const char*>(std::memchr(buff_, '\n', pos_));
+				if(nl != nullptr) {
+					org = nl - buff_ + 1;
+				}
+			}
+			if(org >= pos_) {
+				write_all_(fd, &buff_[org], BFN - org);
+				org = 0;
+			}
+			write_all_(fd, &buff_[org], pos_ - org);
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  致命的なシグナル（SIGSEGV、SIGBUS、SIGFPE、SIGILL、SIGABRT）で書き出す @n
+					※書き出した後、デフォルトの動作（終了）を行う。 @n
+					※assert は abort（SIGABRT）なので、失敗した時に書き出す。
+			@param[in]	fd	ファイル・ディスクリプタ（通常 STDERR_FILENO）
+		*/
+		//-----------------------------------------------------------------//
+		void dump_on_signal(int fd) noexcept
+		{
+			sig_rec_ = this;
+			sig_fd_ = fd;
+			std::signal(SIGSEGV, signal_);
+#ifdef SIGBUS
+			std::signal(SIGBUS, signal_);
 #endif
-					case 'd':
-					case 'i':
-						mode_ = mode::DECIMAL;
-						return;
-					case 'u':
-						mode_ = mode::U_DECIMAL;
-						return;
-					case 'x':
-						mode_ = mode::HEX;
-						return;
-					case 'X':
-						mode_ = mode::HEX_CAPS;
-						return;
-					case 'y':
-						mode_ = mode::FIXED_REAL;
-						return;
-					case 'f':
-					case 'F':
-						mode_ = mode::REAL;
-						return;
-					case 'e':
-						mode_ = mode::EXPONENT;
-						return;
-					case 'E':
-						mode_ = mode::EXPONENT_CAPS;
-						return;
-					case 'g':
-						mode_ = mode::REAL_AUTO;
-						return;
-					case 'G':
-						mode_ = mode::REAL_AUTO_CAPS;
-						return;
-					case 'p':
-						mode_ = mode::POINTER;
-						return;
-					case '%':
-						chaout_(ch);
-						md = apmd::none;
-						break;
-					default:
-						chaout_(ch);
-						md = apmd::none;
-						error_ = error::unknown;
-						break;
-					}
-				} else if(ch == '%') {
-					md = apmd::num;
-				} else {
-					chaout_(ch);
+			std::signal(SIGFPE, signal_);
+			std::signal(SIGILL, signal_);
+			std::signal(SIGABRT, signal_);
+		}
+
+
+		/// 保持している文字を捨てる
+		void clear() noexcept { pos_ = 0; full_ = false; }
+
+		/// 保持している文字数
+		uint size() const noexcept { return full_ ? BFN : pos_; }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  配列出力ファンクタ（コンパイル時の変換用） @n
+				※出力先を自分で持つので、basic_format の中に置かれ、定数式で変換出来る。 @n
+				※最大 N - 1 文字を保持し、常に終端の０を持つ。 @n
+				※溢れた文字は捨てるが、その数は数え、全体に必要な文字数を返す。
+		@param[in]	N		配列サイズ（終端を含む）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <uint32_t N>
+	struct array_chaout {
+
+		static_assert(N > 0, "utils::array_chaout: N must be greater than 0");
+
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+	private:
+		std::array<char, N>	buff_;
+		uint	pos_;
+		uint	drop_;	///< 溢れて捨てた文字数
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+		*/
+		//-----------------------------------------------------------------//
+		constexpr array_chaout() noexcept : buff_{ }, pos_(0), drop_(0) { }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		constexpr void operator () (char ch) noexcept {
+			if(pos_ < (N - 1)) {
+				buff_[pos_] = ch;
+				++pos_;
+			} else {
+				++drop_;
+			}
+		}
+
+
+		/// 保持している文字を捨てる
+		constexpr void clear() noexcept {
+			while(pos_ > 0) {
+				--pos_;
+				buff_[pos_] = 0;
+			}
+			drop_ = 0;
+		}
+
+		/// 保持している文字数
+		constexpr uint size() const noexcept { return pos_; }
+
+		/// 全て出力するのに必要な文字数（溢れた文字を含む）
+		constexpr uint required_size() const noexcept { return pos_ + drop_; }
+
+		/// 溢れて捨てた文字数
+		constexpr uint lost() const noexcept { return drop_; }
+
+		/// 溢れた場合「true」
+		constexpr bool overflow() const noexcept { return drop_ != 0; }
+
+		/// 文字列
+		constexpr const char* c_str() const noexcept { return buff_.data(); }
+
+		/// 配列の参照
+		constexpr const std::array<char, N>& array() const noexcept { return buff_; }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  シグナル・ハンドラー用出力ファンクタ @n
+				※バッファを自分で持つので、basic_format と共にスタックに置かれる。 @n
+				（静的な変数、ロック、ヒープを使わないので、再入出来る） @n
+				※バッファが一杯になった場合と、破棄される時に、write() で書き出す。 @n
+				※errno は書き出しの前後で保存される。
+		@param[in]	BFN		バッファサイズ
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <uint32_t BFN>
+	struct signal_chaout {
+
+		static_assert(BFN > 0, "utils::signal_chaout: BFN must be greater than 0");
+
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+	private:
+		int		fd_;
+		uint	pos_;
+		uint	size_;	///< 出力した文字数
+		char	buff_[BFN];
+
+		// EINTR は再試行、その他のエラー（EAGAIN など）は捨てる（ハンドラーでは待てない）
+		void write_all_(const char* s, uint n) noexcept
+		{
+			if(fd_ < 0) return;
+			auto err = errno;
+			while(n > 0) {
+				auto ret = ::write(fd_, s, n);
+				if(ret < 0) {
+					if(errno == EINTR) continue;
+					break;
+				}
+				s += ret;
+				n -= static_cast<uint>(ret);
+			}
+			errno = err;
+		}
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+			@param[in]	fd	ファイル・ディスクリプタ（負の場合、出力しない）
+		*/
+		//-----------------------------------------------------------------//
+		explicit signal_chaout(int fd = -1) noexcept : fd_(fd), pos_(0), size_(0) { }
+
+		signal_chaout(const signal_chaout&) = delete;
+		signal_chaout& operator = (const signal_chaout&) = delete;
+
+		~signal_chaout() { flush(); }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		void operator () (char ch) noexcept {
+			if(pos_ >= BFN) {
+				flush();
+			}
+			buff_[pos_] = ch;
+			++pos_;
+			++size_;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ブロック出力（バッファより大きい場合、直接書き出す）
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
+		*/
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept {
+			size_ += n;
+			if((pos_ + n) > BFN) {
+				flush();
+				if(n >= BFN) {
+					write_all_(s, n);
+					return;
+				}
+			}
+			std::memcpy(&buff_[pos_], s, n);
+			pos_ += n;
+		}
+
+
+		/// バッファの文字を書き出す
+		void flush() noexcept {
+			write_all_(buff_, pos_);
+			pos_ = 0;
+		}
+
+		/// 出力した文字数
+		uint size() const noexcept { return size_; }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  FILE 出力ファンクタ @n
+				※stdio のバッファへ直接書き込むので、printf などと出力の順番が保たれる。 @n
+				※FILE は basic_format と共に破棄されるまでロックする。 @n
+				（変換の途中に他のスレッドの出力が混ざらない、文字毎のロックが無い） @n
+				※書き込めなかった文字（putc、fwrite の失敗）は lost() で数え、 @n
+				format のエラーは error::out_overflow になる。 @n
+				（stdio のバッファに入り、後の fflush で失敗する分は数えない）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct file_chaout {
+
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+	private:
+		FILE*	fp_;
+		uint	size_;
+		uint	lost_;
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター（出力先無し、ロックしない）
+		*/
+		//-----------------------------------------------------------------//
+		file_chaout() noexcept : fp_(nullptr), size_(0), lost_(0) { }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+			@param[in]	fp	出力先（nullptr の場合、出力しない）
+		*/
+		//-----------------------------------------------------------------//
+		explicit file_chaout(FILE* fp) noexcept : fp_(fp), size_(0), lost_(0)
+		{
+#ifdef _POSIX_THREAD_SAFE_FUNCTIONS
+			if(fp_ != nullptr) flockfile(fp_);
+#endif
+		}
+
+		file_chaout(const file_chaout&) = delete;
+		file_chaout& operator = (const file_chaout&) = delete;
+
+		~file_chaout()
+		{
+#ifdef _POSIX_THREAD_SAFE_FUNCTIONS
+			if(fp_ != nullptr) funlockfile(fp_);
+#endif
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		void operator () (char ch) noexcept
+		{
+			if(fp_ == nullptr) return;
+#ifdef _POSIX_THREAD_SAFE_FUNCTIONS
+			if(putc_unlocked(ch, fp_) == EOF) ++lost_;
+#else
+			if(putc(ch, fp_) == EOF) ++lost_;
+#endif
+			++size_;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ブロック出力
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
+		*/
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept
+		{
+			if(fp_ == nullptr) return;
+#if defined(__GLIBC__) && defined(_GNU_SOURCE)
+			auto ret = fwrite_unlocked(s, 1, n, fp_);
+#else
+			auto ret = fwrite(s, 1, n, fp_);
+#endif
+			if(ret < n) lost_ += n - static_cast<uint>(ret);
+			size_ += n;
+		}
+
+		/// 出力先
+		FILE* get() const noexcept { return fp_; }
+
+		/// 出力先が有効な場合「true」（無効な場合、format のエラーは error::out_null）
+		bool valid() const noexcept { return fp_ != nullptr; }
+
+		/// 出力した文字数
+		uint size() const noexcept { return size_; }
+
+		/// 書き込めなかった文字数
+		uint lost() const noexcept { return lost_; }
+
+		/// 書き込めなかった文字がある場合「true」
+		bool overflow() const noexcept { return lost_ != 0; }
+	};
+
+
+#ifdef USE_STREAM_FORM
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  std::streambuf 出力ファンクタ @n
+				※ostream の書式、sentry を通さずに、put 領域へ直接書き込む。 @n
+				※std::ostream を与えた場合、tie() のストリームを先に書き出し、 @n
+				unitbuf の場合、破棄される時に書き出す（std::cerr など）。 @n
+				※書き込めなかった文字は lost() で数え、format のエラーは error::out_overflow になる。 @n
+				std::ostream を与えた場合、badbit を設定する（exceptions() の例外は投げない）。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct streambuf_chaout {
+
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+	private:
+		std::streambuf*	sb_;
+		std::ostream*	os_;
+		uint	size_;
+		uint	lost_;
+		bool	unit_;
+
+		// 書き込めなかった文字を数え、ストリームに badbit を設定
+		void lost_add_(uint n) noexcept
+		{
+			lost_ += n;
+			if(os_ == nullptr) return;
+#ifdef __cpp_exceptions
+			try {  // 状態は、例外を投げる前に設定される
+				os_->setstate(std::ios_base::badbit);
+			} catch(...) { }
+#else
+			os_->setstate(std::ios_base::badbit);
+#endif
+		}
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+			@param[in]	sb	出力先（nullptr の場合、出力しない）
+		*/
+		//-----------------------------------------------------------------//
+		explicit streambuf_chaout(std::streambuf* sb = nullptr) noexcept :
+			sb_(sb), os_(nullptr), size_(0), lost_(0), unit_(false) { }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+			@param[in]	os	出力ストリーム（good() で無い場合、出力しない）
+		*/
+		//-----------------------------------------------------------------//
+		explicit streambuf_chaout(std::ostream& os) noexcept :
+			sb_(os.good() ? os.rdbuf() : nullptr), os_(&os), size_(0), lost_(0),
+			unit_((os.flags() & std::ios_base::unitbuf) != 0)
+		{
+			auto tie = os.tie();
+			if(sb_ != nullptr && tie != nullptr && tie->rdbuf() != nullptr) {
+				tie->rdbuf()->pubsync();
+			}
+		}
+
+		streambuf_chaout(const streambuf_chaout&) = delete;
+		streambuf_chaout& operator = (const streambuf_chaout&) = delete;
+
+		~streambuf_chaout()
+		{
+			if(unit_ && sb_ != nullptr) sb_->pubsync();
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		void operator () (char ch) noexcept
+		{
+			if(sb_ == nullptr) return;
+			if(std::streambuf::traits_type::eq_int_type(sb_->sputc(ch), std::streambuf::traits_type::eof())) {
+				lost_add_(1);
+			}
+			++size_;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ブロック出力
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
+		*/
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept
+		{
+			if(sb_ == nullptr) return;
+			auto ret = sb_->sputn(s, n);
+			if(ret != static_cast<std::streamsize>(n)) {
+				lost_add_(n - static_cast<uint>(ret < 0 ? 0 : ret));
+			}
+			size_ += n;
+		}
+
+		/// 書き込めなかった文字数
+		uint lost() const noexcept { return lost_; }
+
+		/// 書き込めなかった文字がある場合「true」
+		bool overflow() const noexcept { return lost_ != 0; }
+
+		/// 出力先が有効な場合「true」（無効、good() で無い場合、format のエラーは error::out_null）
+		bool valid() const noexcept { return sb_ != nullptr; }
+
+		/// 出力した文字数
+		uint size() const noexcept { return size_; }
+	};
+#endif
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  出力ファンクタを basic_format の中に置くか検査 @n
+				※静的な出力ファンクタを使わないので、定数式で変換出来る（array_chaout）。 @n
+				※静的な変数を使わないので、シグナル・ハンドラーで使える（signal_chaout）。 @n
+				※出力先を format 毎に与える（file_chaout、streambuf_chaout）。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class CHAOUT>
+	struct is_chaout_local : std::false_type { };
+
+	template <uint32_t N>
+	struct is_chaout_local<array_chaout<N> > : std::true_type { };
+
+	template <uint32_t BFN>
+	struct is_chaout_local<signal_chaout<BFN> > : std::true_type { };
+
+	template <>
+	struct is_chaout_local<file_chaout> : std::true_type { };
+
+#ifdef USE_STREAM_FORM
+	template <>
+	struct is_chaout_local<streambuf_chaout> : std::true_type { };
+#endif
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  出力ファンクタがシグナル・ハンドラー用か検査 @n
+				※非同期シグナル安全では無い変換（%t の localtime_r など）を行わない。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class CHAOUT>
+	struct is_chaout_signal : std::false_type { };
+
+	template <uint32_t BFN>
+	struct is_chaout_signal<signal_chaout<BFN> > : std::true_type { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  他の出力ファンクタへの参照（ユーザー型の変換の context::format 用） @n
+				※format が自分で持つ出力ファンクタ（array_chaout など）へ、 @n
+				入れ子の format から出力する。 @n
+				※ブロック出力、溢れの検出は、参照先が持つ場合だけ持つ。
+		@param[in]	CHAOUT	参照する出力ファンクタ
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class CHAOUT>
+	class chaout_ref {
+		CHAOUT*	ref_;
+
+	public:
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+		constexpr explicit chaout_ref(CHAOUT& ref) noexcept : ref_(&ref) { }
+
+		constexpr void operator () (char ch) noexcept { (*ref_)(ch); }
+
+		template <class C = CHAOUT>
+		constexpr auto write(const char* s, uint n) noexcept -> decltype(std::declval<C&>().write(s, n)) {
+			return ref_->write(s, n);
+		}
+
+		template <class C = CHAOUT>
+		constexpr auto lost() const noexcept -> decltype(std::declval<const C&>().lost()) { return ref_->lost(); }
+
+		template <class C = CHAOUT>
+		constexpr auto overflow() const noexcept -> decltype(std::declval<const C&>().overflow()) { return ref_->overflow(); }
+
+		constexpr auto size() const noexcept { return ref_->size(); }
+
+		/// 参照先
+		constexpr CHAOUT& get() const noexcept { return *ref_; }
+	};
+
+	/// 出力ファンクタを参照する chaout_ref（参照の参照にしない）
+	template <class CHAOUT>
+	struct chaout_ref_of {
+		typedef chaout_ref<CHAOUT> type;
+		static constexpr CHAOUT& target(CHAOUT& c) noexcept { return c; }
+	};
+
+	template <class CHAOUT>
+	struct chaout_ref_of<chaout_ref<CHAOUT> > {
+		typedef chaout_ref<CHAOUT> type;
+		static constexpr CHAOUT& target(chaout_ref<CHAOUT>& c) noexcept { return c.get(); }
+	};
+
+	template <class CHAOUT>
+	struct is_chaout_local<chaout_ref<CHAOUT> > : std::true_type { };
+
+	template <class CHAOUT>
+	struct is_chaout_signal<chaout_ref<CHAOUT> > : is_chaout_signal<CHAOUT> { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  出力ファンクタがブロック出力（write）を持つか検査 @n
+				※持たない場合は、１文字出力を繰り返す。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class CHAOUT, class = void>
+	struct has_chaout_write : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_write<CHAOUT, std::void_t<decltype(std::declval<CHAOUT&>().write(
+		std::declval<const char*>(), 0u))> > : std::true_type { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  バイト列（メモリーダンプ「%m」、「%M」用）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct byte_span {
+		const void*	org;	///< 先頭
+		uint32_t	len;	///< バイト数
+		size_t		ofs;	///< 表示するオフセットの初期値
+
+		byte_span(const void* org_, uint32_t len_, size_t ofs_ = 0) noexcept :
+			org(org_), len(len_), ofs(ofs_) { }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  128 ビット整数（__int128、unsigned __int128）か検査 @n
+				※-std=c++17（GNU 拡張無し）では、std::is_integral が「false」になる。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class T>
+	struct is_format_int128 : std::false_type { };
+
+#ifdef __SIZEOF_INT128__
+	template <>
+	struct is_format_int128<__int128> : std::true_type { };
+
+	template <>
+	struct is_format_int128<unsigned __int128> : std::true_type { };
+#endif
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  ユーザー型の変換（特殊化して使う） @n
+				template <class CTX> static void format(CTX& ctx, const T& val); @n
+				※ADL で見つかる format_value(CTX& ctx, const T& val) でも良い。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class T, class = void>
+	struct format_traits { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  ユーザー型の変換を持つか検査（ADL の format_value、format_traits）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class T, class CTX, class = void>
+	struct has_format_value : std::false_type { };
+
+	template <class T, class CTX>
+	struct has_format_value<T, CTX, std::void_t<decltype(format_value(
+		std::declval<CTX&>(), std::declval<const T&>()))> > : std::true_type { };
+
+	template <class T, class CTX, class = void>
+	struct has_format_traits : std::false_type { };
+
+	template <class T, class CTX>
+	struct has_format_traits<T, CTX, std::void_t<decltype(format_traits<T>::format(
+		std::declval<CTX&>(), std::declval<const T&>()))> > : std::true_type { };
+
+	template <class T, class CTX>
+	struct is_format_custom : std::integral_constant<bool,
+		has_format_value<T, CTX>::value || has_format_traits<T, CTX>::value> { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  範囲（begin、end を持つ型）か検査 @n
+				※文字列（std::string、std::string_view、char 配列）は除く。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class T, class = void>
+	struct is_format_range : std::false_type { };
+
+	template <class T>
+	struct is_format_range<T, std::void_t<decltype(std::begin(std::declval<const T&>())),
+		decltype(std::end(std::declval<const T&>()))> > : std::integral_constant<bool,
+		!std::is_same<T, std::string>::value && !std::is_same<T, std::string_view>::value &&
+		!std::is_same<typename std::remove_cv<typename std::remove_extent<T>::type>::type, char>::value> { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  範囲の区切り、括弧の指定（join で生成する）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class R>
+	struct range_join {
+		const R&	range;	///< 範囲
+		const char*	sep;	///< 区切り
+		const char*	open;	///< 開き括弧
+		const char*	close;	///< 閉じ括弧
+	};
+
+
+	//-----------------------------------------------------------------//
+	/*!
+		@brief  範囲を、区切り、括弧を指定して表示
+		@param[in]	r		範囲
+		@param[in]	sep		区切り
+		@param[in]	open	開き括弧
+		@param[in]	close	閉じ括弧
+		@return range_join
+	*/
+	//-----------------------------------------------------------------//
+	template <class R>
+	range_join<R> join(const R& r, const char* sep = ", ", const char* open = "", const char* close = "") noexcept
+	{
+		return range_join<R>{ r, sep, open, close };
+	}
+
+	template <class T>
+	struct is_range_join : std::false_type { };
+
+	template <class R>
+	struct is_range_join<range_join<R> > : std::true_type { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief	format 基本クラス定義
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct base_format {
+
+		static constexpr uint16_t VERSION = 145;		///< バージョン番号（整数）
+
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		/*!
+			@brief  エラー種別
+		*/
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		enum class error : uint8_t {
+			none,			///< エラー無し
+			null,			///< 無効なポインター
+			unknown,		///< 不明な「型」
+			different,		///< 異なる「型」
+			over,			///< 数値の領域外（%c で char が扱える数値以外）
+			out_null,		///< 文字出力先が無効
+			out_overflow,	///< 文字出力先がオーバーフローした場合
+		};
+
+
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		/*!
+			@brief  中断、再開の状態 @n
+					※出力先が一杯になった位置を、セグメント（コンストラクターが０、 @n
+					以降「%」毎に１つ進む）と、セグメント内の出力済み文字数で保持する。 @n
+					※値の変換が終わった後の文字列で中断した場合、再開時に値を変換しない。
+		*/
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		struct resume_state {
+			uint32_t	seg;	///< 中断したセグメント
+			uint32_t	ofs;	///< 出力済みの文字数（lit の場合、値の後の文字列の）
+			bool		lit;	///< 値の後の文字列で中断した場合「true」
+			bool		pend;	///< 中断している場合「true」
+
+			resume_state() noexcept : seg(0), ofs(0), lit(false), pend(false) { }
+
+			/// 出力が中断している場合「true」
+			bool pending() const noexcept { return pend; }
+
+			void reset() noexcept { seg = 0; ofs = 0; lit = false; pend = false; }
+		};
+
+
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		/*!
+			@brief  定数式で変換するコンストラクターの選択（出力ファンクタが array_chaout の場合）
+		*/
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		struct constant_t { };
+		static constexpr constant_t constant = { };
+
+	protected:
+		/// 10^n (n = 0 to 19)
+		static constexpr uint64_t pow10_tbl_[20] = {
+			1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+			100000000ull, 1000000000ull, 10000000000ull, 100000000000ull,
+			1000000000000ull, 10000000000000ull, 100000000000000ull,
+			1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+			1000000000000000000ull, 10000000000000000000ull
+		};
+
+#ifndef NO_FLOAT_FORM
+		/// 10^n を正規化（最上位ビットを 63 に）する為のシフト量
+		static constexpr uint8_t pow10_lz_[20] = {
+			63, 60, 57, 54, 50, 47, 44, 40, 37, 34, 30, 27, 24, 20, 17, 14, 10, 7, 4, 0
+		};
+
+		/// 10^-n の正規化仮数（2^(pow10_lz_[n] - 127) 倍で 10^-n）
+		static constexpr uint64_t pow10_rcp_[20] = {
+			0x8000'0000'0000'0000, 0xcccc'cccc'cccc'cccd, 0xa3d7'0a3d'70a3'd70a, 0x8312'6e97'8d4f'df3b,
+			0xd1b7'1758'e219'652c, 0xa7c5'ac47'1b47'8423, 0x8637'bd05'af6c'69b6, 0xd6bf'94d5'e57a'42bc,
+			0xabcc'7711'8461'cefd, 0x8970'5f41'36b4'a597, 0xdbe6'fece'bded'd5bf, 0xafeb'ff0b'cb24'aaff,
+			0x8cbc'cc09'6f50'88cc, 0xe12e'1342'4bb4'0e13, 0xb424'dc35'095c'd80f, 0x901d'7cf7'3ab0'acd9,
+			0xe695'94be'c44d'e15b, 0xb877'aa32'36a4'b449, 0x9392'ee8e'921d'5d07, 0xec1e'4a7d'b695'61a5
+		};
+#endif
+
+#ifndef NO_TIME_FORM
+		static constexpr uint32_t time_prefix_len_ = 19;	///< YYYY-MM-DD HH:MM:SS
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  日付と秒までの文字列を返す @n
+					※スレッド毎にキャッシュし、秒が変わった場合だけ作り直す。 @n
+					※変換出来ない場合（localtime_r の失敗、年が４桁に収まらない）、キャッシュしない。
+			@param[in]	t	時刻
+			@return 文字列（time_prefix_len_ 文字、終端無し）、変換出来ない場合 nullptr
+		*/
+		//-----------------------------------------------------------------//
+		static const char* time_prefix_(time_t t) noexcept
+		{
+			struct cache_t {
+				time_t	sec;
+				bool	valid;
+				char	str[time_prefix_len_];
+			};
+			static thread_local cache_t cache = { 0, false, { } };
+			if(cache.valid && cache.sec == t) {
+				return cache.str;
+			}
+
+			struct tm tm;
+#ifdef WIN32
+			if(localtime_s(&tm, &t) != 0) return nullptr;
+#else
+			if(localtime_r(&t, &tm) == nullptr) return nullptr;
+#endif
+			if(tm.tm_year < -1900 || tm.tm_year > (9999 - 1900)) return nullptr;
+			auto put = [](char* out, uint32_t v, uint32_t n) {
+				while(n > 0) {
+					--n;
+					out[n] = (v % 10) + '0';
+					v /= 10;
+				}
+			};
+			auto out = cache.str;
+			put(&out[0], tm.tm_year + 1900, 4);
+			out[4] = '-';
+			put(&out[5], tm.tm_mon + 1, 2);
+			out[7] = '-';
+			put(&out[8], tm.tm_mday, 2);
+			out[10] = ' ';
+			put(&out[11], tm.tm_hour, 2);
+			out[13] = ':';
+			put(&out[14], tm.tm_min, 2);
+			out[16] = ':';
+			put(&out[17], tm.tm_sec, 2);
+			cache.sec = t;
+			cache.valid = true;
+			return cache.str;
+		}
+#endif
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  出力ファンクタがエラー（get_error、overflow）を持つか検査
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class CHAOUT, class = void>
+	struct has_chaout_error : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_error<CHAOUT, std::void_t<decltype(std::declval<const CHAOUT&>().get_error())> > :
+		std::true_type { };
+
+	template <class CHAOUT, class = void>
+	struct has_chaout_overflow : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_overflow<CHAOUT, std::void_t<decltype(std::declval<const CHAOUT&>().overflow())> > :
+		std::true_type { };
+
+	template <class CHAOUT, class = void>
+	struct has_chaout_lost : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_lost<CHAOUT, std::void_t<decltype(std::declval<const CHAOUT&>().lost())> > :
+		std::true_type { };
+
+	template <class CHAOUT, class = void>
+	struct has_chaout_valid : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_valid<CHAOUT, std::void_t<decltype(std::declval<const CHAOUT&>().valid())> > :
+		std::true_type { };
+
+	template <class CHAOUT, class = void>
+	struct has_chaout_required : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_required<CHAOUT, std::void_t<decltype(std::declval<const CHAOUT&>().required_size())> > :
+		std::true_type { };
+
+	template <class CHAOUT, class = void>
+	struct has_chaout_skip : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_skip<CHAOUT, std::void_t<decltype(std::declval<CHAOUT&>().skip(0u))> > :
+		std::true_type { };
+
+	template <class CHAOUT, class = void>
+	struct has_chaout_flush : std::false_type { };
+
+	template <class CHAOUT>
+	struct has_chaout_flush<CHAOUT, std::void_t<decltype(std::declval<CHAOUT&>().flush())> > :
+		std::true_type { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  分配出力ファンクタ @n
+				※一度変換した文字列を、複数の出力ファンクタへ出力する。 @n
+				※ブロック（write）単位で分配し、ブロック出力を持たない出力ファンクタは、 @n
+				１文字出力を繰り返す。 @n
+				※個々の出力ファンクタは at<N>() で参照する。
+		@param[in]	CH	出力ファンクタ
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class... CH>
+	class tee_chaout {
+	public:
+		typedef unsigned int uint;	// 通常 8/16 ビットマイコンでは 16 ビットサイズ
+
+		static constexpr uint32_t NUM = sizeof...(CH);	///< 出力ファンクタの数
+
+	private:
+		std::tuple<CH...>	ch_;
+
+		template <class F>
+		void each_(F f) noexcept { std::apply([&f](CH&... c) { (f(c), ...); }, ch_); }
+
+		template <class C>
+		static base_format::error error_(const C& c) noexcept
+		{
+			if constexpr (has_chaout_error<C>::value) {
+				return c.get_error();
+			} else if constexpr (has_chaout_overflow<C>::value) {
+				return c.overflow() ? base_format::error::out_overflow : base_format::error::none;
+			} else {
+				return base_format::error::none;
+			}
+		}
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ファンクタ用オペレータ
+			@param[in]	ch	出力文字
+		*/
+		//-----------------------------------------------------------------//
+		void operator () (char ch) noexcept {
+			each_([ch](auto& c) { c(ch); });
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  ブロック出力
+			@param[in]	s	出力文字列
+			@param[in]	n	文字数
+		*/
+		//-----------------------------------------------------------------//
+		void write(const char* s, uint n) noexcept {
+			each_([s, n](auto& c) {
+				if constexpr (has_chaout_write<typename std::remove_reference<decltype(c)>::type>::value) {
+					c.write(s, n);
+				} else {
+					for(uint i = 0; i < n; ++i) c(s[i]);
+				}
+			});
+		}
+
+
+		void flush() noexcept {
+			each_([](auto& c) {
+				if constexpr (has_chaout_flush<typename std::remove_reference<decltype(c)>::type>::value) {
+					c.flush();
+				}
+			});
+		}
+
+
+		void clear() noexcept { each_([](auto& c) { c.clear(); }); }
+
+
+		/// 最初の出力ファンクタの出力サイズ
+		auto size() const noexcept { return std::get<0>(ch_).size(); }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  出力ファンクタの参照
+			@return 出力ファンクタ
+		*/
+		//-----------------------------------------------------------------//
+		template <uint32_t N>
+		auto& at() noexcept { return std::get<N>(ch_); }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  出力ファンクタ毎のエラーを返す @n
+					※get_error を持つ場合はその値、overflow を持つ場合は out_overflow
+			@param[in]	idx	出力ファンクタの番号
+			@return エラー
+		*/
+		//-----------------------------------------------------------------//
+		base_format::error get_error(uint32_t idx) const noexcept
+		{
+			auto err = base_format::error::none;
+			uint32_t i = 0;
+			std::apply([&](const CH&... c) { ((i++ == idx ? (void)(err = error_(c)) : (void)0), ...); }, ch_);
+			return err;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  最初に見つかったエラーを返す
+			@return エラー
+		*/
+		//-----------------------------------------------------------------//
+		base_format::error get_error() const noexcept
+		{
+			for(uint32_t i = 0; i < NUM; ++i) {
+				auto err = get_error(i);
+				if(err != base_format::error::none) return err;
+			}
+			return base_format::error::none;
+		}
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  format の変換コア（出力ファンクタに依存しない部分） @n
+				・書式の解析、数値の文字列化、浮動小数点の正規化、メモリーダンプの行の構築を、 @n
+				テンプレートでは無いクラスにまとめる。 @n
+				・basic_format は、構築した文字列を出力ファンクタへ送るだけなので、 @n
+				複数の出力ファンクタを使うプログラムでも、変換の本体は１つになる。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	class format_core : public base_format {
+	protected:
+		enum class mode : uint8_t {
+			CHA,			///< 文字
+			STR,			///< 文字列
+			BINARY,			///< ２進
+			OCTAL,			///< ８進
+			DECIMAL,		///< １０進
+			U_DECIMAL,		///< １０進（符号無し）
+			HEX_CAPS,		///< １６進（大文字）
+			HEX,			///< １６進（小文字）
+			POINTER,		///< ポインター（１６進）
+			FIXED_REAL,		///< 固定小数点
+			REAL,			///< 浮動小数点
+			EXPONENT_CAPS,	///< 浮動小数点 exp 形式(E)
+			EXPONENT,		///< 浮動小数点 exp 形式(e)
+			REAL_AUTO_CAPS,	///< 浮動小数点自動(G)
+			REAL_AUTO,		///< 浮動小数点自動(g)
+			HEX_REAL_CAPS,	///< １６進浮動小数点(A)
+			HEX_REAL,		///< １６進浮動小数点(a)
+			DUMP_CAPS,		///< メモリーダンプ（大文字）
+			DUMP,			///< メモリーダンプ（小文字）
+			TIME,			///< 時刻
+			NONE			///< 不明
+		};
+
+		/// 文字列のエスケープ（%js、%vs）
+		enum class escape : uint8_t {
+			NONE,	///< 無し
+			JSON,	///< JSON の文字列（「"」「\」、制御文字）
+			CSV		///< CSV のフィールド（「"」「,」、改行を含む場合、「"」で囲み、「"」を重ねる）
+		};
+
+		const char*	form_;
+
+		// ８進表示に必要な文字数＋サイン＋ターミネーター（１０進表示は２０桁必要）
+		// ※２進表示は、バッファを使わない
+		char		buff_[22 + 1 + 1];
+
+		uint16_t	num_;
+		uint16_t	point_;
+		uint8_t		bitlen_;
+		uint8_t		udec_num_;
+
+		error		error_;
+		mode		mode_;
+		bool		zerosupp_;
+		bool		sign_;
+		bool		nega_;
+		bool		set_num_;
+		bool		set_poi_;
+		bool		auto_mode_;
+		bool		exp_mode_;
+		escape		esc_;
+
+		static constexpr char nullstr_[] = "(nullptr)";
+
+		format_core(const char* form) noexcept :
+			form_(form),
+			num_(0),
+			point_(0),
+			bitlen_(0),
+			udec_num_(0),
+			error_(error::none),
+			mode_(mode::NONE), zerosupp_(false), sign_(false), nega_(false),
+			set_num_(false), set_poi_(false), auto_mode_(false), exp_mode_(false), esc_(escape::NONE)
+		{ }
+
+		// 定数式で使う場合は、全てのメンバーを初期化する
+		constexpr format_core(constant_t tag, const char* form) noexcept :
+			form_(form),
+			buff_{ },
+			num_(0),
+			point_(0),
+			bitlen_(0),
+			udec_num_(0),
+			error_(error::none),
+			mode_(mode::NONE), zerosupp_(false), sign_(false), nega_(false),
+			set_num_(false), set_poi_(false), auto_mode_(false), exp_mode_(false), esc_(escape::NONE)
+		{
+			static_cast<void>(tag);
+		}
+
+		constexpr void reset_() noexcept {
+			num_ = 0;
+			point_ = 0;
+			bitlen_ = 0;
+			udec_num_ = 0;
+			mode_ = mode::NONE;
+			zerosupp_ = false;
+			sign_ = false;
+			nega_ = false;
+			set_num_ = false;
+			set_poi_ = false;
+			auto_mode_ = false;
+			exp_mode_ = false;
+			esc_ = escape::NONE;
+		}
+
+
+		/// 書式以外の文字列（scan_ の戻り値、レジスターで返せる大きさ）
+		struct span_t {
+			const char*	lit;	///< 出力する文字列
+			uint32_t	len;	///< 出力する文字列の長さ（無い場合 0）
+			bool		more;	///< 出力した後、続けて解析する場合「true」
+		};
+
+
+		// 変換指定子で解析を終える
+		FORMAT_CORE_INLINE constexpr span_t conv_(const char* top, uint32_t n) noexcept {
+#ifdef USE_ESCAPE_FORM
+			if(esc_ != escape::NONE && mode_ != mode::STR) {  // エスケープは %s だけ
+				error_ = error::unknown;
+			}
+#endif
+			return span_t{ top, n, false };
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  次の変換指定子まで書式を解析 @n
+					※変換指定子の前の文字列を返す。 @n
+					※「%%」、不明な変換の後に文字列が続く場合、途中で戻るので、 @n
+					文字列を出力した後、esc を「true」にして再度呼ぶ。
+			@param[in]	esc	途中で戻った後の場合「true」
+			@return 出力する文字列
+		*/
+		//-----------------------------------------------------------------//
+		FORMAT_CORE_INLINE constexpr span_t scan_(bool esc) noexcept {
+			enum class apmd : uint8_t {
+				none,
+				num,	// 数字
+				point,	// 小数点
+				bitlen	// 固定小数点、ビット長さ
+			};
+
+			if(form_ == nullptr) {
+				error_ = error::null;
+				return span_t{ nullptr, 0, false };
+			}
+			const char* top = esc ? form_ - 1 : form_;  // 書式以外の文字列は、まとめて出力
+			for(;;) {
+				const char* p = form_;  // 書式以外の文字列（メンバーを更新せずに進める）
+				char ch = 0;
+				while((ch = *p) != 0 && ch != '%') {
+					++p;
+				}
+				form_ = p;
+				if(ch == 0) {  // 終端に留める（引数が多い場合）
+					return span_t{ top, static_cast<uint32_t>(p - top), false };
+				}
+				uint32_t n = static_cast<uint32_t>(p - top);  // 「%」の前の文字列の長さ
+				++form_;
+				auto md = apmd::num;
+				while(md != apmd::none && (ch = *form_++) != 0) {
+					switch(ch) {
+					case '+':
+						sign_ = true;
+						break;
+					case '-':
+						nega_ = true;
+						break;
+					case '0':
+					case '1':
+					case '2':
+					case '3':
+					case '4':
+					case '5':
+					case '6':
+					case '7':
+					case '8':
+					case '9':
+						ch -= '0';
+						if(md == apmd::num) {
+							if(num_ == 0 && ch == 0) {
+								zerosupp_ = true;
+							}
+							num_ *= 10;
+							num_ += static_cast<uint8_t>(ch);
+							set_num_ = true;
+						} else if(md == apmd::point) {
+							point_ *= 10;
+							point_ += static_cast<uint16_t>(ch);
+							set_poi_ = true;
+						} else if(md == apmd::bitlen) {
+							bitlen_ *= 10;
+							bitlen_ += static_cast<uint8_t>(ch);
+						}
+						break;
+					case '.':
+						md = apmd::point;
+						break;
+					case ':':
+						md = apmd::bitlen;
+						break;
+#ifdef USE_ESCAPE_FORM
+					case 'j':
+						esc_ = escape::JSON;
+						break;
+					case 'v':
+						esc_ = escape::CSV;
+						break;
+#endif
+					case 's':
+						mode_ = mode::STR;
+						return conv_(top, n);
+					case 'c':
+						mode_ = mode::CHA;
+						return conv_(top, n);
+#ifndef NO_BIN_FORM
+					case 'b':
+						mode_ = mode::BINARY;
+						return conv_(top, n);
+#endif
+#ifndef NO_OCTAL_FORM
+					case 'o':
+						mode_ = mode::OCTAL;
+						return conv_(top, n);
+#endif
+					case 'd':
+					case 'i':
+						mode_ = mode::DECIMAL;
+						return conv_(top, n);
+					case 'u':
+						mode_ = mode::U_DECIMAL;
+						return conv_(top, n);
+					case 'x':
+						mode_ = mode::HEX;
+						return conv_(top, n);
+					case 'X':
+						mode_ = mode::HEX_CAPS;
+						return conv_(top, n);
+					case 'y':
+						mode_ = mode::FIXED_REAL;
+						return conv_(top, n);
+					case 'f':
+					case 'F':
+						mode_ = mode::REAL;
+						return conv_(top, n);
+					case 'e':
+						mode_ = mode::EXPONENT;
+						return conv_(top, n);
+					case 'E':
+						mode_ = mode::EXPONENT_CAPS;
+						return conv_(top, n);
+					case 'g':
+						mode_ = mode::REAL_AUTO;
+						return conv_(top, n);
+					case 'G':
+						mode_ = mode::REAL_AUTO_CAPS;
+						return conv_(top, n);
+#ifndef NO_FLOAT_FORM
+					case 'a':
+						mode_ = mode::HEX_REAL;
+						return conv_(top, n);
+					case 'A':
+						mode_ = mode::HEX_REAL_CAPS;
+						return conv_(top, n);
+#endif
+					case 'p':
+						mode_ = mode::POINTER;
+						return conv_(top, n);
+#ifndef NO_DUMP_FORM
+					case 'm':
+						mode_ = mode::DUMP;
+						return conv_(top, n);
+					case 'M':
+						mode_ = mode::DUMP_CAPS;
+						return conv_(top, n);
+#endif
+#ifndef NO_TIME_FORM
+					case 't':
+						mode_ = mode::TIME;
+						return conv_(top, n);
+#endif
+					default:
+						error_ = error::unknown;
+						[[fallthrough]];
+					case '%':  // 次の文字列に含める
+						if(n > 0) {  // 「%」の前の文字列を先に出力
+							return span_t{ top, n, true };
+						}
+						top = form_ - 1;
+						md = apmd::none;
+						break;
+					}
+				}
+				if(md != apmd::none) {  // 変換指定子の途中で終端
+					--form_;
+					return span_t{ top, n, false };
+				}
+			}
+		}
+
+
+		// buff_ の終端までの文字数（build_xxx_ で構築した文字列の長さ）
+		constexpr uint32_t buff_len_(const char* p) const noexcept {
+			return static_cast<uint32_t>(&buff_[sizeof(buff_) - 1] - p);
+		}
+
+#ifndef NO_OCTAL_FORM
+		template <typename T>
+		constexpr char* build_oct_(T v) noexcept {
+			char* p = &buff_[sizeof(buff_) - 1];
+			*p = 0;
+			do {
+				--p;
+				*p = (v & 0b111) + '0';
+				v >>= 3;
+			} while(v != 0) ;
+			return p;
+		}
+#endif
+
+		// １０進文字列を、end の前に構築（end は終端）
+		template <typename T>
+		constexpr char* build_udec_(T v, char* end) noexcept {
+			char* p = end;
+			*p = 0;
+			udec_num_ = 0;
+			do {
+				--p;
+				*p = (v % 10) + '0';
+				v /= 10;
+				++udec_num_;
+			} while(v != 0) ;
+			return p;
+		}
+
+		template <typename T>
+		constexpr char* build_udec_(T v) noexcept {
+			return build_udec_(v, &buff_[sizeof(buff_) - 1]);
+		}
+
+
+		// build_udec_ で構築した１０進文字列（p から end）を 2^lsh 倍する
+		// ※64 ビットを超える大きな値だけなので、速度よりコードサイズ（１０進の桁を lsh 回２倍する）
+		constexpr char* build_udec_shl_(char* p, char* end, uint8_t lsh) noexcept
+		{
+			for(uint8_t i = 0; i < lsh; ++i) {
+				char c = 0;
+				for(char* q = end; q > p; ) {
+					--q;
+					char d = (*q - '0') * 2 + c;
+					c = d >= 10;
+					*q = d - (c ? 10 : 0) + '0';
+				}
+				if(c != 0) {
+					*--p = '1';
+					++udec_num_;
+				}
+			}
+			return p;
+		}
+
+
+		template <typename T>
+		constexpr char* build_hex_(T v, char top) noexcept {
+			char* p = &buff_[sizeof(buff_) - 1];
+			*p = 0;
+			do {
+				--p;
+				char ch = v & 15;
+				if(ch >= 10) ch += top - 10;
+				else ch += '0';
+				*p = ch;
+				v >>= 4;
+			} while(v != 0) ;
+			return p;
+		}
+
+
+#ifdef __SIZEOF_INT128__
+		static constexpr uint32_t u128_len_ = 43;	///< 128 ビット整数の最大桁数（８進）
+
+		// 128 ビット整数の１０進文字列を、end の前に構築
+		// ※10^19 毎に分け（128 ビットの除算は最大２回）、各部分は 64 ビットで変換する
+		static char* build_u128_dec_(unsigned __int128 v, char* end) noexcept
+		{
+			static constexpr uint64_t d19 = pow10_tbl_[19];
+			char* p = end;
+			while((v >> 64) != 0) {
+				auto q = v / d19;
+				auto r = static_cast<uint64_t>(v - q * d19);
+				for(uint32_t i = 0; i < 19; ++i) {
+					*--p = (r % 10) + '0';
+					r /= 10;
+				}
+				v = q;
+			}
+			auto w = static_cast<uint64_t>(v);
+			do {
+				*--p = (w % 10) + '0';
+				w /= 10;
+			} while(w != 0) ;
+			return p;
+		}
+
+
+		// 128 ビット整数の 2^bits 進（８進、１６進）文字列を、end の前に構築
+		static char* build_u128_(unsigned __int128 v, char* end, uint8_t bits, char top) noexcept
+		{
+			uint8_t mask = (1 << bits) - 1;
+			char* p = end;
+			do {
+				char ch = static_cast<uint8_t>(v) & mask;
+				*--p = ch >= 10 ? ch - 10 + top : ch + '0';
+				v >>= bits;
+			} while(v != 0) ;
+			return p;
+		}
+#endif
+
+
+		// num は、VAL のビット数より小さい事
+		template <typename VAL>
+		static constexpr VAL build_mask_(uint8_t num) noexcept {
+			return (static_cast<VAL>(1) << num) - 1;
+		}
+
+
+		// 固定小数点の計算幅：引数の幅（int、レジスター（size_t）より狭い場合は、その幅）
+		// ※8/16/32 ビットのマイコンでは、引数が 64 ビットで無い限り、64 ビットの演算を使わない
+		template <typename U>
+		using fixed_kernel_t = typename std::conditional<
+			(sizeof(U) <= sizeof(unsigned int) && sizeof(size_t) <= sizeof(unsigned int)), unsigned int,
+			typename std::conditional<(sizeof(U) <= sizeof(uint32_t) && sizeof(size_t) <= sizeof(uint32_t)),
+			uint32_t, uint64_t>::type>::type;
+
+		// 固定小数点の文字列の大きさ：小数点、小数部、終端、整数部、終端 @n
+		// ※小数部は 59 ビット（最大 59 桁）、整数部は float の最大（39 桁）が収まる
+		static constexpr uint32_t fixed_len_ = 64;
+
+		template <typename K>
+		constexpr char* build_fixed_(char* buf, K v, bool sign, char& sch) noexcept {
+			if constexpr (sizeof(K) < sizeof(uint64_t)) {
+				if(bitlen_ >= (sizeof(K) * 8 - 4)) {  // 小数点以下の１桁（×１０）が収まらない場合、広い幅で計算
+					typedef typename std::conditional<(sizeof(K) < sizeof(uint32_t)), uint32_t, uint64_t>::type W;
+					return build_fixed_<W>(buf, v, sign, sch);
+				}
+			}
+			return build_fixed_point_<K>(buf, v, bitlen_, sign, sch);
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  固定小数点の文字列を構築 @n
+					※整数部は buf の後ろ（udec_num_ 文字）、小数部は buf の先頭に構築する。 @n
+					※小数部は buf に収まる桁数まで（残りの「０」は out_fixed_str_ で出力）
+			@param[out]	buf		出力先（fixed_len_ 文字）
+			@param[in]	v		値（絶対値）
+			@param[in]	fixpoi	小数点以下のビット数
+			@param[in]	sign	負の値の場合「true」
+			@param[out]	sch		符号文字（無い場合 0）
+			@param[in]	lsh		整数部の左シフト（64 ビットを超える整数、fixpoi は 0 の事）
+			@return 整数部の先頭
+		*/
+		//-----------------------------------------------------------------//
+		template <typename VAL>
+		constexpr char* build_fixed_point_(char* buf, VAL v, uint8_t fixpoi, bool sign, char& sch, uint8_t lsh = 0) noexcept
+		{
+			// 四捨五入処理用 0.5（端数は切り上げ、ちょうど半分の値が切り捨て側にならないようにする）
+			VAL m = 0;
+			if(fixpoi < (sizeof(VAL) * 8 - 4)) {
+				auto n = point_ + 1;
+				if(n <= std::numeric_limits<VAL>::digits10) {  // 10^n が VAL を超える場合、m は 0
+					auto d = static_cast<VAL>(pow10_tbl_[n]);
+					auto h = static_cast<VAL>(5) << fixpoi;
+					m = h / d;
+					if(m != 0 && (h % d) != 0) ++m;
+				}
+			}
+
+			sch = 0;
+			if(sign) sch = '-';
+			else if(sign_) sch = '+';
+			if(!auto_mode_) {
+				if(num_ >= point_) num_ -= point_;
+				if(num_ > 0 && point_ != 0) {
+					--num_;
+				}
+			}
+			// 整数部と小数部に分けて丸める（引数と同じ幅で、桁上がりが溢れない）
+			VAL ip = 0;
+			VAL fp = 0;
+			if(fixpoi < (sizeof(VAL) * 8 - 4)) {
+				ip = v >> fixpoi;
+				fp = (v & build_mask_<VAL>(fixpoi)) + m;
+				if((fp >> fixpoi) != 0) {
+					++ip;
+					fp &= build_mask_<VAL>(fixpoi);
+				}
+			}
+			char* rnb_org = build_udec_(ip, &buf[fixed_len_ - 1]);
+			if(lsh > 0) {
+				rnb_org = build_udec_shl_(rnb_org, &buf[fixed_len_ - 1], lsh);
+			}
+
+			if(point_ > 0) {  // 小数点以下の構築
+				// 小数点、終端（２文字）と、整数部、終端の間に収まる桁数
+				uint32_t lim = fixed_len_ - 3 - udec_num_;
+				if(point_ < lim) lim = point_;
+				char* out = buf;
+				*out++ = '.';
+				uint32_t l = 0;
+				if(fixpoi < (sizeof(VAL) * 8 - 4)) {
+					VAL dec = fp;
+					while(dec > 0 && l < lim) {
+						dec *= 10;
+						VAL n = dec >> fixpoi;
+						*out++ = n + '0';
+						dec -= n << fixpoi;
+						++l;
+					}
+				}
+				if(auto_mode_) {  // 後ろの「０」を除去
+					while(out > &buf[1]) {
+						if(*(out - 1) == '0') --out;
+						else break;
+					}
+					if(out == &buf[1]) --out;  // '.'
+				} else {
+					while(l < lim) {
+						*out++ = '0';
+						++l;
+					}
+				}
+				*out = 0;
+
+				if(auto_mode_) {  // AUTO モード
+					if(set_num_) {
+						uint32_t unp = out - &buf[0];  // 小数点以下の数（小数点を含む）
+						uint32_t all = unp + udec_num_;
+						if(exp_mode_) all += 4;
+						if(sch != 0) ++all;
+						if(num_ > all) {
+							num_ -= all;  // 空白の数
+							num_ += udec_num_;
+							if(sch != 0) ++num_;
+						} else {
+							num_ = udec_num_;
+						}
+						if(unp == 0 && udec_num_ == 6) {
+
+						}
+					} else {
+						num_ = udec_num_;
+					}
+				}
+			}
+			return rnb_org;
+		}
+
+
+#ifndef NO_FLOAT_FORM
+		// 小数点以下のビット数（正規化された仮数 [1, 10) の固定小数点）
+		static constexpr uint8_t norm_shift_ = 59;
+
+		// 64 x 64 の上位 64 ビット（128 ビット整数が無い場合、32 ビット乗算だけで構成）
+		static uint64_t mul_hi_(uint64_t a, uint64_t b) noexcept
+		{
+#ifdef __SIZEOF_INT128__
+			return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+			uint64_t al = a & 0xffff'ffff;
+			uint64_t ah = a >> 32;
+			uint64_t bl = b & 0xffff'ffff;
+			uint64_t bh = b >> 32;
+			uint64_t lh = al * bh;
+			uint64_t hl = ah * bl;
+			uint64_t mid = ((al * bl) >> 32) + (lh & 0xffff'ffff) + (hl & 0xffff'ffff);
+			return ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  float の絶対値を、仮数 [1, 10)、１０進指数に正規化 @n
+					※整数演算のみ、１０のべき乗は最大 19 乗単位で掛ける
+			@param[in]	fpv		float のビット列（inf、nan 以外）
+			@param[out]	v64		仮数（小数点以下 norm_shift_ ビット）
+			@return １０進指数
+		*/
+		//-----------------------------------------------------------------//
+		static int8_t norm_real_(uint32_t fpv, uint64_t& v64) noexcept
+		{
+			uint64_t x = fpv & 0x7f'ffff;
+			int16_t exp = (fpv >> 23) & 0xff;
+			int16_t e2;
+			uint8_t lz = 40;
+			if(exp == 0) {  // 非正規化数
+				if(x == 0) {
+					v64 = 0;
+					return 0;
+				}
+				e2 = -149;
+				while(((x << lz) >> 63) == 0) ++lz;
+			} else {
+				x |= 0x80'0000;
+				e2 = exp - 150;
+			}
+			x <<= lz;
+			e2 -= lz;  // 値は x * 2^e2
+
+			// 2 進指数から、１０進指数を見積もる（log10(2) ≒ 1233 / 4096）
+			int32_t t = (e2 + 63) * 1233;
+			int16_t dexp = t >= 0 ? (t >> 12) : -((-t + 4095) >> 12);
+
+			int16_t k = -dexp;
+			while(k != 0) {
+				if(k > 0) {
+					int16_t n = k > 19 ? 19 : k;
+					x = mul_hi_(x, pow10_tbl_[n] << pow10_lz_[n]);
+					e2 += 64 - pow10_lz_[n];
+					k -= n;
+				} else {
+					int16_t n = -k > 19 ? 19 : -k;
+					x = mul_hi_(x, pow10_rcp_[n]);
+					e2 += pow10_lz_[n] - 63;
+					k += n;
+				}
+				if((x >> 63) == 0) {
+					x <<= 1;
+					--e2;
+				}
+			}
+			auto sft = -e2 - norm_shift_;
+			if(sft < 0 || sft > 63) {
+				v64 = 0;
+				return 0;
+			}
+			// 乗算の切り捨て誤差（数 ulp）で、ちょうど半分の値が切り捨て側にならないよう補正
+			v64 = (x >> sft) + 4;
+
+			// 見積もりの誤差を補正
+			static constexpr uint64_t one = static_cast<uint64_t>(1) << norm_shift_;
+			if(v64 >= (one * 10)) {
+				v64 /= 10;
+				++dexp;
+			} else if(v64 < one) {
+				v64 *= 10;
+				--dexp;
+			}
+			return dexp;
+		}
+
+
+		// 小数点以下 point 桁で丸めた場合に 10.0 になる場合、桁を繰り上げる
+		static void norm_round_(uint64_t& v64, int8_t& dexp, uint16_t point) noexcept
+		{
+			static constexpr uint64_t one = static_cast<uint64_t>(1) << norm_shift_;
+			if(point >= 19) return;
+			auto rnd = (one * 5) / pow10_tbl_[point + 1];
+			if((v64 + rnd) >= (one * 10)) {
+				v64 /= 10;
+				++dexp;
+			}
+		}
+
+
+		static uint32_t real_bits_(float v) noexcept
+		{
+			uint32_t fpv;
+			std::memcpy(&fpv, &v, sizeof(fpv));
+			return fpv;
+		}
+
+
+		// 固定小数点表示（%f）の仮数と、小数点以下のビット数
+		// ※2^63 以上の場合、負の値（整数部の左シフト）を返す
+		static int16_t fixed_real_(uint32_t fpv, uint64_t& v64) noexcept
+		{
+			int16_t exp = (fpv >> 23) & 0xff;
+			exp -= 127;	// bias (-127)
+			int32_t val = fpv & 0x7fffff;	// 23 bits
+			int16_t shift = 23;
+			if(val == 0 && exp == -127) { // [0.0]
+			} else {
+				val |= 0x800000; // add offset 1.0
+			}
+			shift -= exp;
+
+			// 64 ビットに拡張（整数部と丸めの桁上がりを残して、小数点以下を最大 59 ビットまで増やす）
+			v64 = static_cast<uint64_t>(val);
+			if(shift < 59) {
+				int16_t n = 59 - shift;
+				if(n > 39) n = 39;
+				shift += n;
+				v64 <<= n;
+			}
+			return shift;
+		}
+
+
+		// %g、%G：有効桁 P（精度、標準 6）で、指数が -4 未満、P 以上の場合、指数表示（「true」を返す）
+		// ※指数表示の場合、v64、dexp に仮数と指数を返す
+		bool auto_real_(uint32_t fpv, uint64_t& v64, int8_t& dexp) noexcept
+		{
+			uint16_t prec = point_;
+			if(prec == 0) prec = 1;
+			dexp = norm_real_(fpv, v64);
+			norm_round_(v64, dexp, prec - 1);
+
+			mode_ = mode::REAL;
+			if((fpv & 0x7fff'ffff) != 0 && (dexp < -4 || dexp >= prec)) {
+				exp_mode_ = true;
+				point_ = prec - 1;
+				if(point_ == 0 && set_num_ && num_ > 4) {  // 指数部の文字数
+					num_ -= 4;
+				}
+				return true;
+			}
+			point_ = prec - 1 - dexp;
+			return false;
+		}
+
+
+		static constexpr uint32_t hex_real_digits_ = 13;	///< %a の小数部の有効桁数（52 ビット）
+		static constexpr uint32_t hex_real_point_max_ = 32;	///< %.Na の N の最大（超えた分は「0」も省く）
+		/// %a の最大文字数（0x1.fff...p-1022）
+		static constexpr uint32_t hex_real_len_ = 2 + 1 + 1 + hex_real_point_max_ + 2 + 4;
+
+		// float のビット列を、double の形式（小数部 52 ビット、指数）に変換、整数部を返す
+		// ※printf と同じく、非正規化数は正規化する（除算、浮動小数点演算は使わない）
+		static uint8_t hex_real_float_(uint32_t fpv, uint64_t& frac, int16_t& exp) noexcept
+		{
+			uint32_t f = fpv & 0x7f'ffff;
+			int16_t e = (fpv >> 23) & 0xff;
+			exp = 0;
+			frac = 0;
+			if(e == 0) {
+				if(f == 0) return 0;
+				e = 1;
+				while((f & 0x80'0000) == 0) {
+					f <<= 1;
+					--e;
+				}
+				f &= 0x7f'ffff;
+			}
+			exp = e - 127;
+			frac = static_cast<uint64_t>(f) << (52 - 23);
+			return 1;
+		}
+
+
+		// double のビット列から、小数部 52 ビットと指数を取り出し、整数部を返す（非正規化数は 0）
+		static uint8_t hex_real_double_(uint64_t fpv, uint64_t& frac, int16_t& exp) noexcept
+		{
+			frac = fpv & 0xf'ffff'ffff'ffff;
+			int16_t e = (fpv >> 52) & 0x7ff;
+			if(e == 0) {
+				exp = frac != 0 ? -1022 : 0;
+				return 0;
+			}
+			exp = e - 1023;
+			return 1;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  １６進浮動小数点（%a、%A）の文字列を構築 @n
+					精度（%.Na）が指定された場合、N 桁に丸める（最近接偶数）、@n
+					指定が無い場合、小数部の末尾の「0」を省く。
+			@param[out]	tmp		出力先（hex_real_len_ 文字）
+			@param[in]	frac	小数部（52 ビット）
+			@param[in]	exp		指数（2 のべき）
+			@param[in]	lead	整数部
+			@param[in]	top		'a' 又は 'A'
+			@return 文字数
+		*/
+		//-----------------------------------------------------------------//
+		uint32_t build_hex_real_(char* tmp, uint64_t frac, int16_t exp, uint8_t lead, char top) const noexcept
+		{
+			uint32_t dig = hex_real_digits_;
+			uint32_t pad = 0;  // 有効桁を超える精度の「0」
+			if(set_poi_) {
+				if(point_ < hex_real_digits_) {
+					dig = point_;
+					uint8_t sh = (hex_real_digits_ - dig) * 4;
+					auto rem = frac & ((static_cast<uint64_t>(1) << sh) - 1);
+					auto half = static_cast<uint64_t>(1) << (sh - 1);
+					frac >>= sh;
+					bool odd = (dig > 0 ? frac : lead) & 1;
+					if(rem > half || (rem == half && odd)) {
+						++frac;
+						if((frac >> (dig * 4)) != 0) {  // 整数部へ桁上がり
+							frac = 0;
+							++lead;
+						}
+					}
+				} else {
+					pad = (point_ < hex_real_point_max_ ? point_ : hex_real_point_max_) - hex_real_digits_;
+				}
+			} else if(frac == 0) {
+				dig = 0;
+			} else {
+				while((frac & 15) == 0) {
+					frac >>= 4;
+					--dig;
+				}
+			}
+
+			char* p = tmp;
+			*p++ = '0';
+			*p++ = top + ('x' - 'a');
+			*p++ = lead + '0';
+			if(dig > 0) {
+				*p++ = '.';
+				for(uint32_t i = dig; i > 0; --i) {
+					char ch = (frac >> ((i - 1) * 4)) & 15;
+					*p++ = ch >= 10 ? ch - 10 + top : ch + '0';
+				}
+				for(; pad > 0; --pad) *p++ = '0';
+			}
+			*p++ = top + ('p' - 'a');
+			if(exp < 0) {
+				*p++ = '-';
+				exp = -exp;
+			} else {
+				*p++ = '+';
+			}
+			char* q = p;
+			do {
+				*q++ = (exp % 10) + '0';
+				exp /= 10;
+			} while(exp != 0) ;
+			for(char* r = q - 1; p < r; ++p, --r) {
+				auto ch = *p;
+				*p = *r;
+				*r = ch;
+			}
+			return static_cast<uint32_t>(q - tmp);
+		}
+#endif
+
+
+		// 文字列の長さ（定数式の場合は、strlen、memchr を使わない）
+		static constexpr uint32_t str_len_(const char* str) noexcept
+		{
+			if(FORMAT_CONSTANT_EVALUATED()) {
+				uint32_t n = 0;
+				while(str[n] != 0) ++n;
+				return n;
+			}
+			return std::strlen(str);
+		}
+
+
+		// 最大 max 文字までの長さ（max 文字を超えて走査しない）
+		static constexpr uint32_t str_len_(const char* str, uint32_t max) noexcept
+		{
+			if(FORMAT_CONSTANT_EVALUATED()) {
+				uint32_t n = 0;
+				while(n < max && str[n] != 0) ++n;
+				return n;
+			}
+			auto p = static_cast<const char*>(std::memchr(str, 0, max));
+			return p != nullptr ? static_cast<uint32_t>(p - str) : max;
+		}
+
+
+#ifndef NO_DUMP_FORM
+		// ８バイト分のニブル（各バイトの下位４ビット）を、並列に１６進文字へ変換
+		static uint64_t hex_nibble_(uint64_t n, char top) noexcept
+		{
+			static constexpr uint64_t lsb = 0x0101'0101'0101'0101;
+			auto adj = ((n + lsb * 6) >> 4) & lsb;  // 10 以上のバイトは 1
+			return n + lsb * '0' + adj * static_cast<uint64_t>(top - '0' - 10);
+		}
+
+
+		static constexpr uint32_t dump_line_max_ = 32;	///< １行の最大バイト数
+		static constexpr uint32_t dump_ofs_max_ = sizeof(size_t) * 2;	///< オフセットの最大桁数
+		/// １行の最大文字数（オフセット＋ダンプ＋グループ間＋アスキー）
+		static constexpr uint32_t dump_line_size_ = dump_ofs_max_ + 2 + dump_line_max_ * 3 + dump_line_max_ + 2 + dump_line_max_ + 2;
+
+		/// メモリーダンプの書式（%N.G:Lm）
+		struct dump_t {
+			uint32_t	lw;		///< １行のバイト数 N（16）
+			uint32_t	grp;	///< グループのバイト数 G（8）
+			uint32_t	ol;		///< オフセットの桁数 L（8）
+			char		top;	///< 16 進の 'a' 又は 'A'
+		};
+
+		dump_t dump_spec_() const noexcept
+		{
+			dump_t t = { 16, 8, 8, 'a' };
+			if(set_num_ && num_ > 0) t.lw = num_ < dump_line_max_ ? num_ : dump_line_max_;
+			if(set_poi_) t.grp = point_;
+			if(bitlen_ > 0) t.ol = bitlen_ < dump_ofs_max_ ? bitlen_ : dump_ofs_max_;
+			if(mode_ == mode::DUMP_CAPS) t.top = 'A';
+			return t;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  メモリーダンプ（hexdump -C 形式）の１行を構築
+			@param[out]	line	出力先（dump_line_size_ 文字）
+			@param[in]	src		先頭
+			@param[in]	n		バイト数（t.lw 以下）
+			@param[in]	ofs		表示するオフセット
+			@param[in]	t		書式（dump_spec_）
+			@return 文字数
+		*/
+		//-----------------------------------------------------------------//
+		static uint32_t dump_line_(char* line, const uint8_t* src, uint32_t n, size_t ofs, const dump_t& t) noexcept
+		{
+			static constexpr uint64_t lsb = 0x0101'0101'0101'0101;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+			static constexpr bool little = false;
+#else
+			static constexpr bool little = true;
+#endif
+			auto top = t.top;
+			auto lw = t.lw;
+			auto grp = t.grp;
+			auto ol = t.ol;
+
+			char* out = line;
+			auto v = ofs;
+			for(uint32_t i = ol; i > 0; --i) {
+				char ch = v & 15;
+				out[i - 1] = ch >= 10 ? ch - 10 + top : ch + '0';
+				v >>= 4;
+			}
+			out += ol;
+			*out++ = ' ';
+			*out++ = ' ';
+			uint32_t g = 0;
+			for(uint32_t i = 0; i < lw; i += 8) {
+				uint64_t w = 0;
+				uint32_t k = 0;  // ８バイトの内、有効なバイト数
+				if(i < n) {
+					k = n - i;
+					if(k > 8) k = 8;
+					std::memcpy(&w, &src[i], k);
+				}
+				auto hi = hex_nibble_((w >> 4) & (lsb * 15), top);
+				auto lo = hex_nibble_(w & (lsb * 15), top);
+				uint32_t e = lw - i;
+				if(e > 8) e = 8;
+				for(uint32_t j = 0; j < e; ++j) {
+					if(j < k) {
+						auto sh = little ? (j * 8) : (56 - j * 8);
+						out[0] = static_cast<char>(hi >> sh);
+						out[1] = static_cast<char>(lo >> sh);
+					} else {
+						out[0] = ' ';
+						out[1] = ' ';
+					}
+					out[2] = ' ';
+					out += 3;
+					++g;
+					if(g == grp) {
+						g = 0;
+						if((i + j + 1) < lw) *out++ = ' ';
+					}
+				}
+			}
+			*out++ = ' ';
+			*out++ = '|';
+			for(uint32_t i = 0; i < n; ++i) {
+				char ch = src[i];
+				*out++ = (ch >= 0x20 && ch < 0x7f) ? ch : '.';
+			}
+			*out++ = '|';
+			*out++ = '\n';
+			return static_cast<uint32_t>(out - line);
+		}
+#endif
+
+
+#ifdef USE_ESCAPE_FORM
+		static constexpr uint32_t esc_block_ = 96;	///< エスケープした文字列をまとめて出力する大きさ
+
+		/// エスケープが必要な文字（JSON、CSV の順、[0]: この値未満の文字、[1]～[4]: 文字）
+		static constexpr uint8_t esc_set_[2][5] = {
+			{ 0x20, '"', '\\', '"', '"' },
+			{ 0x00, '"', ',', '\n', '\r' }
+		};
+
+		// エスケープが必要な文字か
+		static constexpr bool esc_char_(char ch, escape esc) noexcept
+		{
+			const auto& t = esc_set_[static_cast<uint8_t>(esc) - 1];
+			auto c = static_cast<uint8_t>(ch);
+			return c < t[0] || c == t[1] || c == t[2] || c == t[3] || c == t[4];
+		}
+
+
+		// ８バイト（SWAR）に、エスケープが必要な文字が有る場合「true」
+		// ※値が c のバイト、c 未満のバイトの最上位ビットを立てる（有無の判定は正確）
+		static bool esc_hit_(uint64_t w, escape esc) noexcept
+		{
+			constexpr uint64_t lsb = 0x0101'0101'0101'0101;
+			const auto& t = esc_set_[static_cast<uint8_t>(esc) - 1];
+			auto eq = [w](uint8_t c) { auto x = w ^ (lsb * c); return (x - lsb) & ~x; };
+			auto hit = ((w - lsb * t[0]) & ~w) | eq(t[1]) | eq(t[2]) | eq(t[3]) | eq(t[4]);
+			return (hit & (lsb << 7)) != 0;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  エスケープが必要な最初の文字を探す @n
+					※８バイト毎（SWAR）に検査し、見つかった８バイトの中だけ１文字ずつ調べる。
+			@param[in]	s	文字列
+			@param[in]	len	文字列の長さ
+			@param[in]	esc	エスケープの種類
+			@return 最初の位置（無い場合 len）
+		*/
+		//-----------------------------------------------------------------//
+		static constexpr uint32_t esc_scan_(const char* s, uint32_t len, escape esc) noexcept
+		{
+			uint32_t i = 0;
+			if(!FORMAT_CONSTANT_EVALUATED()) {
+				for(; (i + 8) <= len; i += 8) {
+					uint64_t w = 0;
+					std::memcpy(&w, &s[i], 8);
+					if(esc_hit_(w, esc)) break;
+				}
+			}
+			for(; i < len; ++i) {
+				if(esc_char_(s[i], esc)) break;
+			}
+			return i;
+		}
+
+
+		/// JSON の２文字のエスケープ（文字、「\」の後の文字の組）
+		static constexpr char esc_json_[] = "\"\"\\\\\bb\ff\nn\rr\tt";
+
+		// エスケープした文字を tmp に構築し、文字数を返す（最大６文字）
+		static constexpr uint32_t esc_str_(char* tmp, char ch, escape esc) noexcept
+		{
+			if(esc == escape::CSV) {  // 「"」は重ね、他はそのまま
+				tmp[0] = ch;
+				tmp[1] = ch;
+				return ch == '"' ? 2 : 1;
+			}
+			tmp[0] = '\\';
+			for(uint32_t i = 0; i < (sizeof(esc_json_) - 1); i += 2) {
+				if(ch == esc_json_[i]) {
+					tmp[1] = esc_json_[i + 1];
+					return 2;
+				}
+			}
+			char lo = ch & 15;
+			tmp[1] = 'u';
+			tmp[2] = '0';
+			tmp[3] = '0';
+			tmp[4] = ((ch >> 4) & 15) + '0';
+			tmp[5] = lo >= 10 ? lo - 10 + 'a' : lo + '0';
+			return 6;
+		}
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  エスケープした文字列をブロックに構築 @n
+					※エスケープが無い８バイトはまとめて、他は１文字ずつ変換する。 @n
+					※出力ファンクタ毎に展開しない様に、ブロック単位で返す。
+			@param[out]	blk	出力先（esc_block_ 文字）
+			@param[in]	s	文字列
+			@param[in]	len	文字列の長さ
+			@param[in,out]	i	変換する位置（進める）
+			@param[in]	esc	エスケープの種類
+			@return ブロックの文字数
+		*/
+		//-----------------------------------------------------------------//
+		static constexpr uint32_t esc_fill_(char* blk, const char* s, uint32_t len, uint32_t& i, escape esc) noexcept
+		{
+			uint32_t pos = 0;
+			while(i < len && pos <= (esc_block_ - 8 * 6)) {
+				uint32_t k = len - i;
+				if(k > 8) k = 8;
+				if(!FORMAT_CONSTANT_EVALUATED() && k == 8) {
+					uint64_t w = 0;
+					std::memcpy(&w, &s[i], 8);
+					if(!esc_hit_(w, esc)) {
+						std::memcpy(&blk[pos], &w, 8);
+						pos += 8;
+						i += 8;
+						continue;
+					}
+				}
+				for(; k > 0; --k) {
+					char ch = s[i++];
+					if(esc_char_(ch, esc)) {
+						pos += esc_str_(&blk[pos], ch, esc);
+					} else {
+						blk[pos++] = ch;
+					}
+				}
+			}
+			return pos;
+		}
+#endif
+
+
+#ifndef NO_TIME_FORM
+		static constexpr uint32_t time_str_max_ = time_prefix_len_ + 1 + 9;	///< 時刻の最大文字数
+
+		// 時刻の文字列を構築：日付と秒まで（time_prefix_ のキャッシュ）を写し、秒以下（精度の桁数）だけ変換
+		uint32_t build_time_(char* tmp, const char* prefix, uint32_t nsec) const noexcept
+		{
+			std::memcpy(tmp, prefix, time_prefix_len_);
+			uint32_t len = time_prefix_len_;
+			if(set_poi_ && point_ > 0) {
+				uint32_t n = point_ < 9 ? point_ : 9;
+				tmp[len++] = '.';
+				auto v = nsec / static_cast<uint32_t>(pow10_tbl_[9 - n]);
+				for(uint32_t i = n; i > 0; --i) {
+					tmp[len + i - 1] = (v % 10) + '0';
+					v /= 10;
+				}
+				len += n;
+			}
+			return len;
+		}
+#endif
+
+
+		// 解析した書式（範囲の要素毎に戻す）
+		struct spec_t {
+			uint16_t	num;
+			uint16_t	point;
+			uint8_t		bitlen;
+			mode		md;
+			bool		zerosupp;
+			bool		sign;
+			bool		nega;
+			bool		set_num;
+			bool		set_poi;
+			escape		esc;
+		};
+
+		spec_t save_spec_() const noexcept {
+			return spec_t{ num_, point_, bitlen_, mode_, zerosupp_, sign_, nega_, set_num_, set_poi_, esc_ };
+		}
+
+		void load_spec_(const spec_t& t) noexcept {
+			num_ = t.num;
+			point_ = t.point;
+			bitlen_ = t.bitlen;
+			mode_ = t.md;
+			zerosupp_ = t.zerosupp;
+			sign_ = t.sign;
+			nega_ = t.nega;
+			set_num_ = t.set_num;
+			set_poi_ = t.set_poi;
+			esc_ = t.esc;
+			auto_mode_ = false;
+			exp_mode_ = false;
+		}
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  簡易 format クラス
+		@param[in]	CHAOUT	文字出力ファンクタ
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class CHAOUT>
+	class basic_format : public format_core {
+
+		static CHAOUT	chaout_;
+
+		// 中断、再開（出力ファンクタが overflow、skip を持つ場合のみ）
+#ifndef NO_RESUME_FORM
+		static constexpr bool resume_enable_ = has_chaout_overflow<CHAOUT>::value && has_chaout_skip<CHAOUT>::value;
+#else
+		static constexpr bool resume_enable_ = false;
+#endif
+		// ※st 以外は、st がある場合だけ seg_init_ で初期化する（再開しない式の構築を軽くする）
+		struct resume_work_ {
+			resume_state*	st = nullptr;
+			uint32_t	seg;		///< 現在のセグメント
+			uint32_t	top;		///< セグメント先頭の出力サイズ
+			uint32_t	lit_top;	///< 値の後の文字列、先頭の出力サイズ
+			uint32_t	res_seg;	///< 再開するセグメント
+			uint32_t	res_ofs;	///< 再開するセグメントで、出力済みの文字数
+			bool		res_lit;	///< 値の後の文字列から再開する場合
+			bool		lit;		///< 値の変換が終わっている場合
+		};
+		struct resume_none_ { };
+		typename std::conditional<resume_enable_, resume_work_, resume_none_>::type rsm_;
+
+		// 構築時に、出力ファンクタが捨てていた文字数（出力ファンクタは共有なので、この式の溢れだけ見る）
+		static constexpr bool lost_enable_ = has_chaout_lost<CHAOUT>::value;
+		struct lost_none_ { };
+		FORMAT_NO_UNIQUE_ADDRESS typename std::conditional<lost_enable_, uint32_t, lost_none_>::type lost_top_;
+
+		// 出力ファンクタを自分で持つ場合（array_chaout、signal_chaout）、静的な chaout_ は使わない
+		static constexpr bool local_enable_ = is_chaout_local<CHAOUT>::value;
+		struct local_none_ { };
+		FORMAT_NO_UNIQUE_ADDRESS typename std::conditional<local_enable_, CHAOUT, local_none_>::type local_;
+
+		constexpr CHAOUT& out_() noexcept {
+			if constexpr (local_enable_) {
+				return local_;
+			} else {
+				return chaout_;
+			}
+		}
+
+		constexpr const CHAOUT& out_() const noexcept {
+			if constexpr (local_enable_) {
+				return local_;
+			} else {
+				return chaout_;
+			}
+		}
+
+		// この式で、出力先が溢れた場合「true」
+		constexpr bool overflow_() const noexcept {
+			if constexpr (lost_enable_) {
+				return out_().lost() != lost_top_;
+			} else if constexpr (has_chaout_overflow<CHAOUT>::value) {
+				return out_().overflow();
+			} else {
+				return false;
+			}
+		}
+
+		// 溢れの基準を取り、再開する場合、出力済みのセグメントを出力ファンクタで捨てる
+		constexpr void seg_init_() noexcept {
+			if constexpr (lost_enable_) {
+				lost_top_ = out_().lost();
+			}
+			if constexpr (resume_enable_) {
+				if(rsm_.st != nullptr) {
+					seg_start_();
+				}
+			}
+		}
+
+		// ※以下の再開の処理は、再開する式だけで使うので、インライン展開しない（変換の度の処理を小さく保つ）
+		FORMAT_NOINLINE void seg_start_() noexcept {
+			rsm_.seg = 0;
+			rsm_.top = out_().size();
+			rsm_.lit_top = 0;
+			rsm_.res_seg = rsm_.st->seg;
+			rsm_.res_ofs = rsm_.st->ofs;
+			rsm_.res_lit = rsm_.st->lit;
+			rsm_.lit = false;
+			rsm_.st->reset();
+			out_().skip(rsm_.res_seg > 0 ? ~0u : rsm_.res_ofs);
+		}
+
+		// セグメントの開始（値を変換する場合「true」）
+		FORMAT_NOINLINE bool seg_next_() noexcept {
+			++rsm_.seg;
+			rsm_.top = out_().size();
+			if(rsm_.seg < rsm_.res_seg) {
+				return false;
+			}
+			if(rsm_.seg == rsm_.res_seg) {  // 再開するセグメント
+				if(rsm_.res_lit) {
+					return false;
+				}
+				out_().skip(rsm_.res_ofs);
+			}
+			return true;
+		}
+
+		// 値の変換の終了、値の後の文字列から再開する場合、出力済みの文字を捨てる
+		FORMAT_NOINLINE void seg_lit_() noexcept {
+			rsm_.lit = !overflow_();
+			rsm_.lit_top = out_().size();
+			if(rsm_.seg == rsm_.res_seg && rsm_.res_lit) {
+				out_().skip(rsm_.res_ofs);
+			}
+		}
+
+		// 出力先が溢れた位置を記録
+		FORMAT_NOINLINE void seg_overflow_() noexcept {
+			error_ = error::out_overflow;
+			bool same = rsm_.seg == rsm_.res_seg && rsm_.res_lit == rsm_.lit;
+			rsm_.st->seg = rsm_.seg;
+			rsm_.st->ofs = (out_().size() - (rsm_.lit ? rsm_.lit_top : rsm_.top)) + (same ? rsm_.res_ofs : 0);
+			rsm_.st->lit = rsm_.lit;
+			rsm_.st->pend = true;
+		}
+
+		// セグメントの開始、出力済みの値は変換しない
+		constexpr bool seg_begin_() noexcept {
+			if constexpr (resume_enable_) {
+				if(rsm_.st != nullptr) {
+					return seg_next_();
+				}
+			}
+			return true;
+		}
+
+		// 値の変換の終了
+		constexpr void seg_field_() noexcept {
+			if constexpr (resume_enable_) {
+				if(rsm_.st != nullptr) {
+					seg_lit_();
+				}
+			}
+		}
+
+		// セグメントの終了、再開する場合、出力先が溢れた位置を記録して止める
+		// ※再開しない場合は、必要な文字数を数える為に変換を続ける（エラーは get_error で返す）
+		constexpr void seg_end_() noexcept {
+			if constexpr (resume_enable_) {
+				if(rsm_.st != nullptr && error_ == error::none && overflow_()) {
+					seg_overflow_();
+				}
+			}
+		}
+
+		// 値を変換して、次の変換指定子まで進める（operator % の本体）
+		// ※中断、再開する場合、出力済みのセグメントの値は変換しない
+		template <typename T>
+		constexpr basic_format& arg_(const T& val) noexcept
+		{
+			if(error_ != error::none) {
+				return *this;
+			}
+
+			if(seg_begin_()) {
+				value_(val);
+			}
+			seg_field_();
+
+			reset_();
+			next_();
+			seg_end_();
+			return *this;
+		}
+
+		constexpr void str_(const char* str) noexcept {
+			char ch = 0;
+			while((ch = *str++) != 0) out_()(ch);
+		}
+
+		// 出力ファンクタがブロック出力を持つ場合は、まとめて出力
+		constexpr void out_block_(const char* str, uint32_t len) noexcept {
+			if constexpr (has_chaout_write<CHAOUT>::value) {
+				out_().write(str, len);
+			} else {
+				while(len > 0) {
+					out_()(*str++);
+					--len;
+				}
+			}
+		}
+
+		constexpr void str_(const char* str, uint32_t len) noexcept {
+			out_block_(str, len);
+		}
+
+		// 書式以外の文字列を出力しながら、次の変換指定子まで進める
+		constexpr void next_() noexcept {
+			bool esc = false;
+			for(;;) {
+				auto sp = scan_(esc);
+				if(sp.len > 0) {
+					out_block_(sp.lit, sp.len);
 				}
+				if(!sp.more) break;
+				esc = true;
 			}
 		}
 
 
-		void zero_spc_(char sign, uint16_t n) noexcept {
+		constexpr void zero_spc_(char sign, uint32_t n) noexcept {
 			auto num = num_;
 			if(sign != 0 && num > 0) { num--; } 
 			if(n > 0 && n < num) {
 				auto cnt = num - n;
 				if(!nega_ && zerosupp_) {
-					if(sign != 0) { chaout_(sign); }
+					if(sign != 0) { out_()(sign); }
 					while(cnt > 0) {
 						--cnt;
-						chaout_('0');
+						out_()('0');
 					}
 				} else {
 					while(cnt > 0) {
 						--cnt;
-						chaout_(' ');
+						out_()(' ');
 					}
-					if(!nega_ && sign != 0) { chaout_(sign); }
+					if(!nega_ && sign != 0) { out_()(sign); }
 				}
 			} else {
-				if(!nega_ && sign != 0) { chaout_(sign); }
+				if(!nega_ && sign != 0) { out_()(sign); }
 			}
 		}
 
 
-		void out_str_(const char* str, char sign, uint16_t n) noexcept {
+		// n: 文字列の長さ（str の終端は参照しない）
+		constexpr void out_str_(const char* str, char sign, uint32_t n) noexcept {
+			if(n >= num_) {  // 幅が足りている場合（詰め物が無い）
+				if(sign != 0) { out_()(sign); }
+				str_(str, n);
+				return;
+			}
 			if(nega_) {
-				if(sign != 0) { chaout_(sign); }
-				str_(str);
+				if(sign != 0) { out_()(sign); }
+				str_(str, n);
 			}
 
 			zero_spc_(sign, n);
 
-			if(!nega_) { str_(str); }
+			if(!nega_) { str_(str, n); }
 		}
 
 #ifndef NO_BIN_FORM
 		template <typename T>
-		uint8_t out_bin0_(T v, uint8_t n) noexcept {
+		constexpr uint8_t out_bin0_(T v, uint8_t n) noexcept {
 			auto tmp = static_cast<T>(1) << (n - 1);
 			for(uint8_t i = 0; i < n; ++i) {
 				if((v & tmp) != 0) {
-					chaout_('1');
+					out_()('1');
 				} else {
-					chaout_('0');
+					out_()('0');
 				}
 				tmp >>= 1;
 			}
@@ -668,7 +3640,7 @@ namespace utils {
 		}
 
 		template <typename T>
-		void out_bin_(T v) noexcept {
+		constexpr void out_bin_(T v) noexcept {
 			uint8_t n = 0;
 			auto tmp = v;
 			do {
@@ -701,66 +3673,31 @@ namespace utils {
 
 #ifndef NO_OCTAL_FORM
 		template <typename T>
-		void out_oct_(T v) noexcept {
-			char* p = &buff_[sizeof(buff_) - 1];
-			*p = 0;
-			uint8_t n = 0;
-			do {
-				--p;
-				*p = (v & 0b111) + '0';
-				v >>= 3;
-				++n;
-			} while(v != 0) ;
-			out_str_(p, 0, n);
+		constexpr void out_oct_(T v) noexcept {
+			auto p = build_oct_<T>(v);
+			out_str_(p, 0, buff_len_(p));
 		}
 #endif
 
 		template <typename T>
-		char* build_udec_(T v) noexcept {
-			char* p = &buff_[sizeof(buff_) - 1];
-			*p = 0;
-			udec_num_ = 0;
-			do {
-				--p;
-				*p = (v % 10) + '0';
-				v /= 10;
-				++udec_num_;
-			} while(v != 0) ;
-			return p;
-		}
-
-
-		template <typename T>
-		void out_dec_(T v) noexcept {
+		constexpr void out_dec_(T v) noexcept {
 			char sign = 0;
 			if(v < 0) { v = -v; sign = '-'; }
 			else if(sign_) { sign = '+'; }
-			char* tmp;
-			tmp = build_udec_<typename std::make_unsigned<T>::type>(v);
+			char* tmp = build_udec_<typename std::make_unsigned<T>::type>(v);
 			out_str_(tmp, sign, udec_num_);
 		}
 
 
 		template <typename T>
-		void out_hex_(T v, char top) noexcept {
-			char* p = &buff_[sizeof(buff_) - 1];
-			*p = 0;
-			uint8_t n = 0;
-			do {
-				--p;
-				char ch = v & 15;
-				if(ch >= 10) ch += top - 10;
-				else ch += '0';
-				*p = ch;
-				v >>= 4;
-				++n;
-			} while(v != 0) ;
-			out_str_(p, 0, n);
+		constexpr void out_hex_(T v, char top) noexcept {
+			auto p = build_hex_<T>(v, top);
+			out_str_(p, 0, buff_len_(p));
 		}
 
 
 		template <typename T>
-		void decimal_(T val, bool sign) noexcept {
+		constexpr void decimal_(T val, bool sign) noexcept {
 			switch(mode_) {
 #ifndef NO_BIN_FORM
 			case mode::BINARY:
@@ -791,11 +3728,17 @@ namespace utils {
 				break;
 			case mode::FIXED_REAL:
 				if(num_ == 0) num_ = 6;
-				if(val < 0) {
-					sign = true;
-					val = -val;
+				{
+					// sign: 引数が符号付きの型の場合「true」
+					typedef typename std::make_unsigned<T>::type U;
+					bool nega = sign && val < 0;
+					auto u = static_cast<U>(val);
+					if(nega) u = static_cast<U>(-u);
+					char buf[fixed_len_] = { };
+					char sch = 0;
+					auto p = build_fixed_<fixed_kernel_t<U> >(buf, u, nega, sch);
+					out_fixed_str_(buf, p, sch);
 				}
-				out_fixed_point_<uint64_t>(val, bitlen_, sign);
 				break;
 			default:
 				error_ = error::different;
@@ -804,315 +3747,796 @@ namespace utils {
 		}
 
 
-		static uint64_t build_mask_(uint8_t num) noexcept {
-			uint64_t m = 0;
-			while(num > 0) {
-				m += m;
-				++m;
-				--num;
+#ifdef __SIZEOF_INT128__
+		// 128 ビット整数（%d、%u、%x、%X、%o、%b）、buff_ を拡張しない様に、ローカルで構築
+		template <typename T>
+		void decimal128_(T val) noexcept {
+			typedef unsigned __int128 U;
+			char tmp[u128_len_ + 1];
+			char* end = &tmp[u128_len_];
+			char* p = end;
+			char sign = 0;
+			switch(mode_) {
+#ifndef NO_BIN_FORM
+			case mode::BINARY:
+				out_bin_<U>(static_cast<U>(val));
+				return;
+#endif
+#ifndef NO_OCTAL_FORM
+			case mode::OCTAL:
+				p = build_u128_(static_cast<U>(val), end, 3, 'a');
+				break;
+#endif
+			case mode::DECIMAL:
+				{
+					auto s = static_cast<__int128>(val);
+					auto u = static_cast<U>(s);
+					if(s < 0) { u = -u; sign = '-'; }
+					else if(sign_) { sign = '+'; }
+					p = build_u128_dec_(u, end);
+				}
+				break;
+			case mode::U_DECIMAL:
+				if(sign_) sign = '+';
+				p = build_u128_dec_(static_cast<U>(val), end);
+				break;
+			case mode::HEX:
+			case mode::HEX_CAPS:
+				p = build_u128_(static_cast<U>(val), end, 4, mode_ == mode::HEX_CAPS ? 'A' : 'a');
+				break;
+			default:
+				error_ = error::different;
+				return;
+			}
+			out_str_(p, sign, static_cast<uint32_t>(end - p));
+		}
+#endif
+
+
+		// 固定小数点の出力（build_fixed_point_ で構築した文字列、buf に収まらない小数部の「０」）
+		constexpr void out_fixed_str_(const char* buf, const char* rnb_org, char sch) noexcept {
+			out_str_(rnb_org, sch, udec_num_);
+			if(point_ > 0) {
+				uint32_t n = 0;
+				while(buf[n] != 0) ++n;
+				out_block_(buf, n);
+				if(!auto_mode_) {
+					for(uint32_t i = n - 1; i < point_; ++i) out_()('0');
+				}
+			}
+		}
+
+
+		template <typename VAL>
+		constexpr void out_fixed_point_(VAL v, uint8_t fixpoi, bool sign, uint8_t lsh = 0) noexcept {
+			char buf[fixed_len_] = { };
+			char sch = 0;
+			auto p = build_fixed_point_<VAL>(buf, v, fixpoi, sign, sch, lsh);
+			out_fixed_str_(buf, p, sch);
+		}
+
+
+#ifndef NO_FLOAT_FORM
+		// 正規化された仮数と、指数の表示
+		void out_exp_(uint64_t v64, int8_t dexp, bool sign, char e) noexcept
+		{
+			out_fixed_point_<uint64_t>(v64, norm_shift_, sign);
+
+			out_()(e);
+			zerosupp_ = true;
+			sign_ = true;
+			num_ = 3;
+			out_dec_(dexp);
+		}
+
+
+		// inf, nan の場合「true」
+		bool out_inf_nan_(uint32_t fpv) noexcept
+		{
+			if((fpv & 0x7f80'0000) != 0x7f80'0000) return false;
+
+			if(fpv >> 31) out_()('-');
+			if((fpv & 0x7f'ffff) != 0) {
+				out_str_("nan", 0, 3);
+			} else {
+				out_str_("inf", 0, 3);
+			}
+			return true;
+		}
+
+
+		void out_real_(float v, char e) noexcept
+		{
+			auto fpv = real_bits_(v);
+			if(out_inf_nan_(fpv)) return;
+
+			bool sign = fpv >> 31;
+			uint64_t v64 = 0;
+			if(e != 0) {  // エキスポーネント表記
+				auto dexp = norm_real_(fpv, v64);
+				norm_round_(v64, dexp, point_);
+				out_exp_(v64, dexp, sign, e);
+				return;
+			}
+			auto shift = fixed_real_(fpv, v64);
+			if(shift < 0) {  // 2^63 以上：整数部を 64 ビットを超えて構築
+				out_fixed_point_<uint64_t>(v64, 0, sign, static_cast<uint8_t>(-shift));
+			} else {
+				out_fixed_point_<uint64_t>(v64, static_cast<uint8_t>(shift), sign);
+			}
+		}
+
+
+		// %g、%G
+		void out_auto_real_(float v, char e) noexcept
+		{
+			auto fpv = real_bits_(v);
+			if(out_inf_nan_(fpv)) return;
+
+			uint64_t v64 = 0;
+			int8_t dexp = 0;
+			if(auto_real_(fpv, v64, dexp)) {
+				out_exp_(v64, dexp, fpv >> 31, e);
+			} else {
+				out_real_(v, 0);
+			}
+		}
+
+
+		// %a、%A の出力（ゼロ・サプレスの場合、「0x」の後に「0」を詰める）
+		void out_hex_real_(bool nega, uint64_t frac, int16_t exp, uint8_t lead) noexcept
+		{
+			char top = mode_ == mode::HEX_REAL_CAPS ? 'A' : 'a';
+			char tmp[hex_real_len_];
+			auto n = build_hex_real_(tmp, frac, exp, lead, top);
+			char sign = nega ? '-' : (sign_ ? '+' : 0);
+			if(zerosupp_ && !nega_) {
+				if(sign != 0) {
+					out_()(sign);
+					if(num_ > 0) --num_;
+				}
+				out_block_(tmp, 2);
+				num_ = num_ > 2 ? num_ - 2 : 0;
+				out_str_(tmp + 2, 0, n - 2);
+			} else {
+				out_str_(tmp, sign, n);
+			}
+		}
+
+
+		void out_hex_real_(float v) noexcept
+		{
+			auto fpv = real_bits_(v);
+			if(out_inf_nan_(fpv)) return;
+
+			uint64_t frac;
+			int16_t exp;
+			auto lead = hex_real_float_(fpv, frac, exp);
+			out_hex_real_(fpv >> 31, frac, exp, lead);
+		}
+
+
+		// double は、52 ビットの小数部をそのまま表示（long double は double に丸める）
+		void out_hex_real_(double v) noexcept
+		{
+			if constexpr (sizeof(double) != sizeof(uint64_t)) {  // double が 32 ビットの環境
+				out_hex_real_(static_cast<float>(v));
+			} else {
+				uint64_t fpv;
+				std::memcpy(&fpv, &v, sizeof(fpv));
+				if(((fpv >> 52) & 0x7ff) == 0x7ff) {  // inf, nan
+					out_inf_nan_(real_bits_(static_cast<float>(v)));
+					return;
+				}
+				uint64_t frac;
+				int16_t exp;
+				auto lead = hex_real_double_(fpv, frac, exp);
+				out_hex_real_(fpv >> 63, frac, exp, lead);
+			}
+		}
+#endif
+
+#ifdef USE_ESCAPE_FORM
+		// エスケープした文字列の出力（%js、%vs）
+		// ※エスケープが不要な部分は、中間バッファを使わず、まとめて出力する
+		constexpr void out_esc_(const char* s, uint32_t len) noexcept
+		{
+			auto i = esc_scan_(s, len, esc_);
+			if(i == len) {  // エスケープ不要
+				out_str_(s, 0, len);
+				return;
+			}
+
+			char blk[esc_block_] = { };
+			uint32_t n = 0;
+			if(num_ > 0) {  // 幅の指定がある場合、エスケープした文字数を数える
+				n = i;
+				if(esc_ == escape::CSV) n += 2;  // 「"」で囲む
+				for(uint32_t j = i; j < len; ) n += esc_fill_(blk, s, len, j, esc_);
+			}
+			if(!nega_) zero_spc_(0, n);
+			if(esc_ == escape::CSV) out_()('"');
+			if(i > 0) out_block_(s, i);
+			while(i < len) {
+				out_block_(blk, esc_fill_(blk, s, len, i, esc_));
+			}
+			if(esc_ == escape::CSV) out_()('"');
+			if(nega_) zero_spc_(0, n);
+		}
+#endif
+
+		// len: 文字列の長さ（精度「%.Ns」が指定されている場合、N で制限する）
+		constexpr void str_sub_(const char* val, uint32_t len) noexcept
+		{
+			if(mode_ == mode::STR) {
+				if(set_poi_ && len > point_) {
+					len = point_;
+				}
+				// zerosupp_ = false;
+				// ※文字出力で「０サプレス」の場合、スペースに変換しないのが規格の模様
+#ifdef USE_ESCAPE_FORM
+				if(esc_ != escape::NONE) {
+					out_esc_(val, len);
+					return;
+				}
+#endif
+				out_str_(val, 0, len);
+			} else {
+				error_ = error::different;
+			}
+		}
+
+
+		constexpr void str_sub_(const char* val) noexcept
+		{
+			if(val == nullptr) {
+				str_sub_(nullstr_, sizeof(nullstr_) - 1);
+				if(mode_ == mode::STR) {
+					error_ = error::null;
+				}
+			} else if(set_poi_) {  // 精度が指定された場合、N 文字を超えて走査しない
+				str_sub_(val, str_len_(val, point_));
+			} else {
+				str_sub_(val, str_len_(val));
+			}
+		}
+
+
+#ifndef NO_DUMP_FORM
+		// メモリーダンプ（hexdump -C 形式）、１行毎に出力
+		void out_dump_(const uint8_t* src, uint32_t len, size_t ofs) noexcept
+		{
+			char line[dump_line_size_];
+			auto t = dump_spec_();
+			while(len > 0) {
+				uint32_t n = len < t.lw ? len : t.lw;
+				out_block_(line, dump_line_(line, src, n, ofs, t));
+				src += n;
+				len -= n;
+				ofs += n;
+			}
+		}
+#endif
+
+
+#ifndef NO_TIME_FORM
+		// 時刻表示
+		void out_time_(time_t sec, uint32_t nsec) noexcept
+		{
+			if(mode_ != mode::TIME) {
+				error_ = error::different;
+				return;
+			}
+			if constexpr (is_chaout_signal<CHAOUT>::value) {  // localtime_r、thread_local を使わない
+				error_ = error::unknown;
+				return;
+			}
+			auto prefix = time_prefix_(sec);
+			if(prefix == nullptr) {  // 変換出来ない時刻
+				error_ = error::over;
+				prefix = "0000-00-00 00:00:00";
+			}
+			char tmp[time_str_max_];
+			out_str_(tmp, 0, build_time_(tmp, prefix, nsec));
+		}
+#endif
+
+
+		// ポインター値の１６進表示（最近の実装では、大文字で表示）
+		void pointer_(const void* val) noexcept
+		{
+			zerosupp_ = true;
+			if(sizeof(void*) > 4) {
+				num_ = sizeof(size_t) * 2;
+				auto v = reinterpret_cast<size_t>(val);
+				out_hex_<size_t>(v, 'A');
+			} else {
+				num_ = 8;
+				if(sizeof(void*) < 4) {  // 8/16 ビットマイコンの場合
+					num_ = 4;
+				}
+				out_hex_<uint32_t>(reinterpret_cast<size_t>(val), 'A');
+			}
+		}
+
+
+		void value_(const std::string& val) noexcept
+		{
+			if(mode_ == mode::STR) {
+				str_sub_(val.data(), val.size());
+			} else {
+				error_ = error::unknown;
+			}
+		}
+
+
+		constexpr void value_(const char* val) noexcept
+		{
+			if(mode_ == mode::STR) {
+				str_sub_(val);
+			} else if(mode_ == mode::POINTER) {
+				pointer_(static_cast<const void*>(val));
+			} else {
+				error_ = error::unknown;
 			}
-			return m;
 		}
 
 
-		template <typename VAL>
-		void out_fixed_point_(VAL v, uint8_t fixpoi, bool sign) noexcept
+		constexpr void value_(char* val) noexcept { value_(static_cast<const char*>(val)); }
+
+
+		constexpr void value_(std::string_view val) noexcept
 		{
-			// 四捨五入処理用 0.5
-			VAL m = 0;
-			if(fixpoi < (sizeof(VAL) * 8 - 4)) {
-				m = static_cast<VAL>(5) << fixpoi;
-				auto n = point_ + 1;
-				while(n > 0) {
-					m /= 10;
-					--n;
-				}
+			if(mode_ == mode::STR) {
+				str_sub_(val.data(), val.size());
+#ifndef NO_DUMP_FORM
+			} else if(mode_ == mode::DUMP || mode_ == mode::DUMP_CAPS) {
+				out_dump_(reinterpret_cast<const uint8_t*>(val.data()), val.size(), 0);
+#endif
+			} else {
+				error_ = error::unknown;
 			}
+		}
 
-			char sch = 0;
-			if(sign) sch = '-';
-			else if(sign_) sch = '+';
-			v += m;
-			if(!auto_mode_) {
-				if(num_ >= point_) num_ -= point_;
-				if(num_ > 0 && point_ != 0) {
-					--num_;
-				}
-			}
-			char* rnb_org;
-			if(fixpoi < (sizeof(VAL) * 8 - 4)) {
-				rnb_org = build_udec_(v >> fixpoi);
+
+		void value_(const byte_span& val) noexcept
+		{
+#ifndef NO_DUMP_FORM
+			if(mode_ == mode::DUMP || mode_ == mode::DUMP_CAPS) {
+				out_dump_(static_cast<const uint8_t*>(val.org), val.len, val.ofs);
 			} else {
-				rnb_org = build_udec_(0);
+				error_ = error::different;
 			}
+#else
+			error_ = error::unknown;
+#endif
+		}
 
-			if(mode_ == mode::REAL_AUTO || mode_ == mode::REAL_AUTO_CAPS) {
-				// 指定が無い場合６桁を維持
-				if(udec_num_ < 6) {
-					point_ = 6 - udec_num_;
-				} else {
-					point_ = 0;
-				}
-				if(!set_num_) {
-					num_ = udec_num_;
-				}
+
+		template <typename T>
+		void value_(T* val) noexcept
+		{
+			if(mode_ == mode::POINTER) {
+				pointer_(static_cast<const void*>(val));
+			} else {
+				error_ = error::unknown;
 			}
+		}
 
-			if(point_ > 0) {  // 小数点以下の構築
-				char* out = buff_;
-				*out++ = '.';
-				uint16_t l = 0;
-				if(fixpoi < (sizeof(VAL) * 8 - 4)) {
-					VAL dec = v & build_mask_(fixpoi);
-					while(dec > 0) {
-						dec *= 10;
-						VAL n = dec >> fixpoi;
-						*out++ = n + '0';
-						dec -= n << fixpoi;
-						++l;
-						if(l >= point_) break;
+
+#ifndef NO_TIME_FORM
+		void value_(const timespec& val) noexcept
+		{
+			out_time_(val.tv_sec, val.tv_nsec);
+		}
+
+
+		template <typename DUR>
+		void value_(const std::chrono::time_point<std::chrono::system_clock, DUR>& val) noexcept
+		{
+			auto d = val.time_since_epoch();
+			auto sec = std::chrono::floor<std::chrono::seconds>(d);
+			auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d - sec).count();
+			out_time_(static_cast<time_t>(sec.count()), static_cast<uint32_t>(ns));
+		}
+#endif
+
+
+		template <typename R>
+		void value_(const range_join<R>& val) noexcept
+		{
+			range_(val.range, val.sep, val.open, val.close);
+		}
+
+
+		// 数値、ユーザー型、範囲
+		template <typename T>
+		constexpr void value_(const T& val) noexcept
+		{
+			if constexpr (is_format_custom<T, context>::value) {
+				if(mode_ == mode::NONE) {
+					error_ = error::unknown;
+				} else {
+					context ctx(*this);
+					if constexpr (has_format_value<T, context>::value) {
+						format_value(ctx, val);
+					} else {
+						format_traits<T>::format(ctx, val);
 					}
 				}
-				if(auto_mode_) {  // 後ろの「０」を除去
-					while(out > &buff_[1]) {
-						if(*(out - 1) == '0') --out;
-						else break;
+			} else if constexpr (is_format_range<T>::value) {
+				range_(val, ", ", "", "");
+			} else if constexpr (std::is_array<T>::value) {  // char 配列
+				value_(static_cast<const char*>(val));
+#ifdef __SIZEOF_INT128__
+			} else if constexpr (is_format_int128<T>::value) {
+				decimal128_(val);
+#endif
+			} else if constexpr (std::is_integral<T>::value) {
+				if(mode_ == mode::CHA) {
+					auto chn = static_cast<int32_t>(val);
+					if(chn > -128 && chn < 128) {
+						out_()(chn);
+					} else {  // over range
+						error_ = error::over;
 					}
-					if(out == &buff_[1]) --out;  // '.'
+#ifndef NO_TIME_FORM
+				} else if(mode_ == mode::TIME) {  // time_t
+					out_time_(static_cast<time_t>(val), 0);
+#endif
 				} else {
-					while(l < point_) {
-						*out++ = '0';
-						++l;
-					}
+					typedef typename std::make_signed<T>::type S;
+					decimal_<S>(val, std::is_signed<T>::value);
 				}
-				*out = 0;
-
-				if(auto_mode_) {  // AUTO モード
-					if(set_num_) {
-						uint32_t unp = out - &buff_[0];  // 小数点以下の数（小数点を含む）
-						uint32_t all = unp + udec_num_;
-						if(exp_mode_) all += 4;
-						if(sch != 0) ++all;
-						if(num_ > all) {
-							num_ -= all;  // 空白の数
-							num_ += udec_num_;
-							if(sch != 0) ++num_;
-						} else {
-							num_ = udec_num_;
-						}
-						if(unp == 0 && udec_num_ == 6) {
-							
-						}
+#ifndef NO_FLOAT_FORM
+			} else if constexpr (std::is_floating_point<T>::value) {
+				if(!set_poi_) point_ = 6;
+				switch(mode_) {
+				case mode::REAL:
+					out_real_(val, 0);
+					break;
+				case mode::EXPONENT_CAPS:
+					out_real_(val, 'E');
+					break;
+				case mode::EXPONENT:
+					out_real_(val, 'e');
+					break;
+				case mode::REAL_AUTO_CAPS:
+					auto_mode_ = true;
+					out_auto_real_(val, 'E');
+					break;
+				case mode::REAL_AUTO:
+					auto_mode_ = true;
+					out_auto_real_(val, 'e');
+					break;
+				case mode::HEX_REAL_CAPS:
+				case mode::HEX_REAL:
+					if constexpr (std::is_same<T, float>::value) {
+						out_hex_real_(static_cast<float>(val));
 					} else {
-						num_ = udec_num_;
+						out_hex_real_(static_cast<double>(val));
 					}
+					break;
+				default:
+					error_ = error::different;
+					break;
 				}
-			}
-			out_str_(rnb_org, sch, udec_num_);
-			if(point_ > 0) {
-				str_(buff_);
+#endif
+			} else {
+				error_ = error::unknown;
 			}
 		}
 
 
-#ifndef NO_FLOAT_FORM
-		void out_real_(float v, char e) noexcept
+		// 範囲の各要素を、区切りを挟んで変換（エラーで中断）
+		template <typename R, typename F>
+		void each_(const R& r, const char* sep, F f) noexcept
 		{
-			void* p = &v;
-			uint32_t fpv = *(uint32_t*)p;
-			bool sign = fpv >> 31;
-			int16_t exp = (fpv >> 22) & 0x1ff;
+			bool first = true;
+			for(const auto& e : r) {
+				if(!first) str_(sep);
+				first = false;
+				f(e);
+				if(error_ != error::none) break;
+			}
+		}
 
-			if(exp >= 0x1fe) {  // inf, nan の検出
-				if(sign) chaout_('-');
-				if(exp & 1) {
-					out_str_("nan", 0, 3);
-				} else {
-					out_str_("inf", 0, 3);
+
+		// 範囲の変換：書式による分岐はループの外で行い、書式は要素毎に戻す
+		template <typename R>
+		void range_(const R& r, const char* sep, const char* open, const char* close) noexcept
+		{
+			typedef typename std::remove_cv<typename std::remove_reference<
+				decltype(*std::begin(r))>::type>::type E;
+
+			str_(open);
+			bool done = false;
+			if constexpr (std::is_integral<E>::value && !std::is_same<E, bool>::value &&
+				!is_format_int128<E>::value) {
+				typedef typename std::make_signed<E>::type S;
+				typedef typename std::make_unsigned<E>::type U;
+				switch(mode_) {  // 書式が変化しない変換
+				case mode::DECIMAL:
+					each_(r, sep, [this](E v) { out_dec_<S>(v); });
+					done = true;
+					break;
+				case mode::U_DECIMAL:
+					each_(r, sep, [this](E v) {
+						auto tmp = build_udec_<U>(v);
+						out_str_(tmp, sign_ ? '+' : 0, udec_num_);
+					});
+					done = true;
+					break;
+				case mode::HEX:
+				case mode::HEX_CAPS:
+					{
+						char top = mode_ == mode::HEX_CAPS ? 'A' : 'a';
+						each_(r, sep, [this, top](E v) { out_hex_<U>(v, top); });
+					}
+					done = true;
+					break;
+				default:
+					break;
 				}
-				return;
+			} else if constexpr (std::is_convertible<const E&, std::string_view>::value) {
+				if(mode_ == mode::STR) {
+					each_(r, sep, [this](const E& v) { value_(v); });
+					done = true;
+				}
+			}
+			if(!done) {
+				auto t = save_spec_();
+				each_(r, sep, [this, &t](const E& v) {
+					load_spec_(t);
+					value_(v);
+				});
 			}
-			exp >>= 1;
+			str_(close);
+		}
 
-			exp -= 127;	// bias (-127)
-			int32_t val = fpv & 0x7fffff;	// 23 bits
-			int16_t shift = 23;
-			if(val == 0 && exp == -127) { // [0.0]
-			} else {
-				val |= 0x800000; // add offset 1.0
+	public:
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		/*!
+			@brief  ユーザー型の変換に渡すコンテキスト @n
+					※解析した書式と、出力ファンクタへの直接出力を提供する。
+		*/
+		//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+		class context {
+			basic_format&	fmt_;
+
+		public:
+			explicit context(basic_format& fmt) noexcept : fmt_(fmt) { }
+
+			/// 変換文字（'s'、'd' など）
+			char type() const noexcept { return fmt_.form_[-1]; }
+
+			/// 幅（指定が無い場合 0）
+			uint16_t width() const noexcept { return fmt_.set_num_ ? fmt_.num_ : 0; }
+
+			/// 精度が指定されている場合「true」
+			bool has_precision() const noexcept { return fmt_.set_poi_; }
+
+			/// 精度
+			uint16_t precision() const noexcept { return fmt_.point_; }
+
+			/// 左詰め「-」
+			bool left() const noexcept { return fmt_.nega_; }
+
+			/// ０で埋める「0」
+			bool zero() const noexcept { return fmt_.zerosupp_; }
+
+			/// 符号を表示「+」
+			bool sign() const noexcept { return fmt_.sign_; }
+
+			/// 出力ファンクタの参照
+			CHAOUT& chaout() noexcept { return fmt_.out_(); }
+
+			/// １文字出力
+			void put(char ch) noexcept { fmt_.out_()(ch); }
+
+			/// 文字列をそのまま出力
+			void write(const char* str, uint32_t len) noexcept { fmt_.out_block_(str, len); }
+
+			//-------------------------------------------------------------//
+			/*!
+				@brief  「%s」と同じ幅、精度、詰め物で出力
+				@param[in]	str		文字列
+				@param[in]	len		文字列の長さ
+				@param[in]	sign	符号文字（無い場合 0）
+			*/
+			//-------------------------------------------------------------//
+			void out(const char* str, uint32_t len, char sign = 0) noexcept
+			{
+				if(fmt_.set_poi_ && len > fmt_.point_) len = fmt_.point_;
+				fmt_.out_str_(str, sign, len);
 			}
-			shift -= exp;
 
-			// 64 ビットに拡張
-			uint64_t v64 = static_cast<uint64_t>(val);
-			if(shift < 28) {
-				shift += 32;
-				v64 <<= 32;
-			}
-
-			// エキスポーネント表記の場合に乗数を求める。
-			int8_t decexp = 0;
-			if(e != 0) {
-				auto ref = static_cast<uint64_t>(1) << shift;
-				if(v64 < ref) {  // 1.0 以下
-					ref -= ref / 10;  // 0.99999 の場合を考慮する為、誤差分を引く
-					while(v64 < ref) {  
-						v64 *= 10;
-						--decexp;
-					}
+			void out(const char* str) noexcept { out(str, std::strlen(str)); }
+
+			//-------------------------------------------------------------//
+			/*!
+				@brief  同じ出力ファンクタへ出力する format を生成 @n
+						※メンバーを個別の書式で出力する場合に使う。 @n
+						※format が出力ファンクタを自分で持つ場合（array_format、signal_format、 @n
+						file_format、stream_format）、それを参照する format（chaout_ref）を返す。
+				@param[in]	form	フォーマット式
+				@return format
+			*/
+			//-------------------------------------------------------------//
+			constexpr auto format(const char* form) const noexcept
+			{
+				if constexpr (local_enable_) {
+					typedef chaout_ref_of<CHAOUT> R;
+					return basic_format<typename R::type>(constant, R::target(fmt_.out_()), form);
 				} else {
-					auto ref = static_cast<uint64_t>(2) << shift;
-					while(v64 >= ref) {  // 1.9999... 以上の場合
-						v64 /= 10;
-						++decexp;
-					}
+					return basic_format(form);
 				}
 			}
 
-			out_fixed_point_<uint64_t>(v64, shift, sign);
+			/// エラーを設定
+			void set_error(error err) noexcept { fmt_.error_ = err; }
+		};
 
-			if(e != 0) {
-				chaout_(e);
-				zerosupp_ = true;
-				sign_ = true;
-				num_ = 3;
-				out_dec_(decexp);
-			}
-		}
 
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター
+			@param[in]	form	フォーマット式
+		*/
+		//-----------------------------------------------------------------//
+		basic_format(const char* form) noexcept :
+			format_core(form)
+		{
+			seg_init_();
+			next_();
+			seg_end_();
+		}
 
-		static inline float abs_(float val) noexcept { if(val < 0.0f) return -val; else return val; }
 
-		static float pow10_(int n) noexcept
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター（定数式で変換） @n
+					※出力ファンクタを自分で持つ場合（array_chaout）のみ。 @n
+					※全てのメンバーを初期化するので、constexpr 関数の中で使える。
+			@param[in]	tag		base_format::constant
+			@param[in]	form	フォーマット式
+		*/
+		//-----------------------------------------------------------------//
+		constexpr basic_format(constant_t tag, const char* form) noexcept :
+			format_core(tag, form), rsm_{ }, lost_top_{ }, local_{ }
 		{
-			switch(n) {
-			case 4: return 1e4f;
-			case 5: return 1e5f;
-			case 6: return 1e6f;
-			case 7: return 1e7f;
-			case 8: return 1e8f;
-			case 9: return 1e9f;
-			case -4: return 1e-3f;
-			case -5: return 1e-5f;
-			case -6: return 1e-6f;
-			case -7: return 1e-7f;
-			case -8: return 1e-8f;
-			case -9: return 1e-9f;
-			default:
-				break;
-			}
-
-			float v = 1.0f;
-			if(n > 0) {
-				while(n > 0) { v *= 10.0f; --n; }
-			} else {
-				while(n < 0) { v /= 10.0f; ++n; }
-			}
-			return v;
+			static_assert(local_enable_,
+				"utils::basic_format: constant evaluation requires a local output functor (array_chaout)");
+			seg_init_();
+			next_();
+			seg_end_();
 		}
 
 
-		void out_auto_real_(float v, char e) noexcept
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター（出力先を与える） @n
+					※出力ファンクタを自分で持つ場合（signal_chaout、file_chaout、streambuf_chaout）のみ。 @n
+					※出力ファンクタは、この format と共に破棄される。
+			@param[in]	dst		出力先（ファイル・ディスクリプタ、FILE*、std::ostream など）
+			@param[in]	form	フォーマット式
+		*/
+		//-----------------------------------------------------------------//
+		template <class DST>
+		basic_format(DST&& dst, const char* form) noexcept :
+			format_core(form), local_(std::forward<DST>(dst))
 		{
-			if(abs_(v) >= pow10_(6)) {
-				exp_mode_ = true;
-				out_real_(v, e);
-			} else if(abs_(v) < pow10_(-(6 - 2))) {
-				exp_mode_ = true;
-				out_real_(v, e);
-			} else {
-				if(abs_(v) < 1.0f) {  // 小数点以下の場合
-					// 小数点以下の有効桁を表示する為の全体の桁数を求める。
-					int n = point_;
-					if(n > 6) n = 6;
-					for(int i = 1; i < 9; ++i) {
-						if(abs_(v) >= pow10_(-i)) {
-							point_ = i + n - 1;
-							break;
-						}
-					}
-					if(!set_num_) {
-						num_ = point_ + 1;
-					}
-					mode_ = mode::REAL;
+			static_assert(local_enable_,
+				"utils::basic_format: output destination requires a local output functor (signal_chaout, file_chaout)");
+			static_assert(std::is_constructible<CHAOUT, DST&&>::value,
+				"utils::basic_format: output functor can not be constructed from the destination");
+			if constexpr (has_chaout_valid<CHAOUT>::value) {
+				if(!local_.valid()) {
+					error_ = error::out_null;
 				}
-				out_real_(v, 0);
 			}
+			seg_init_();
+			next_();
+			seg_end_();
 		}
-#endif
 
-		void str_sub_(const char* val) noexcept
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター（出力先を与える、定数式で変換） @n
+					※全てのメンバーを初期化するので、constexpr 関数の中で使える（context::format）。
+			@param[in]	tag		base_format::constant
+			@param[in]	dst		出力先（chaout_ref の参照先など）
+			@param[in]	form	フォーマット式
+		*/
+		//-----------------------------------------------------------------//
+		template <class DST>
+		constexpr basic_format(constant_t tag, DST&& dst, const char* form) noexcept :
+			format_core(tag, form), rsm_{ }, lost_top_{ }, local_(std::forward<DST>(dst))
 		{
-			if(mode_ == mode::STR) {
-				if(val == nullptr) {
-					static constexpr char nullstr[] = "(nullptr)";
-					out_str_(nullstr, 0, std::strlen(nullstr));
-					error_ = error::null;
-				} else {
-					// zerosupp_ = false;
-					// ※文字出力で「０サプレス」の場合、スペースに変換しないのが規格の模様
-					out_str_(val, 0, std::strlen(val));
+			static_assert(local_enable_,
+				"utils::basic_format: output destination requires a local output functor (signal_chaout, file_chaout)");
+			static_assert(std::is_constructible<CHAOUT, DST&&>::value,
+				"utils::basic_format: output functor can not be constructed from the destination");
+			if constexpr (has_chaout_valid<CHAOUT>::value) {
+				if(!local_.valid()) {
+					error_ = error::out_null;
 				}
-			} else {
-				error_ = error::different;
 			}
+			seg_init_();
+			next_();
+			seg_end_();
 		}
 
 
-		// ポインター値の１６進表示（最近の実装では、大文字で表示）
-		void pointer_(const void* val) noexcept
+#ifndef NO_RESUME_FORM
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  コンストラクター（中断、再開） @n
+					※出力先が一杯になると、error::out_overflow で中断し、位置を st に記録する。 @n
+					※出力先を空けた後、同じ式を st と共に再度評価すると、中断位置から再開する。 @n
+					（出力済みのセグメントは変換しない）
+			@param[in]	form	フォーマット式
+			@param[in]	st		中断、再開の状態
+		*/
+		//-----------------------------------------------------------------//
+		basic_format(const char* form, resume_state& st) noexcept :
+			format_core(form)
 		{
-			zerosupp_ = true;
-			if(sizeof(void*) > 4) {
-				num_ = sizeof(size_t) * 2;
-				auto v = reinterpret_cast<size_t>(val);
-				out_hex_<size_t>(v, 'A');
-			} else {
-				num_ = 8;
-				if(sizeof(void*) < 4) {  // 8/16 ビットマイコンの場合
-					num_ = 4;
-				}
-				out_hex_<uint32_t>(reinterpret_cast<size_t>(val), 'A');
-			}
+			static_assert(resume_enable_,
+				"utils::basic_format: resume requires overflow() and skip() of output functor");
+			rsm_.st = &st;
+			seg_init_();
+			next_();
+			seg_end_();
 		}
+#endif
+
 
-	public:
 		//-----------------------------------------------------------------//
 		/*!
 			@brief  コンストラクター
 			@param[in]	form	フォーマット式
+			@param[in]	buff	文字バッファ
+			@param[in]	size	文字バッファサイズ
+			@param[in]	append	文字バッファに追加する場合「true」
 		*/
 		//-----------------------------------------------------------------//
-		basic_format(const char* form) noexcept :
-			form_(form),
-			num_(0),
-			point_(0),
-			bitlen_(0),
-			udec_num_(0),
-			error_(error::none),
-			mode_(mode::NONE), zerosupp_(false), sign_(false), nega_(false),
-			set_num_(false), set_poi_(false), auto_mode_(false), exp_mode_(false)
+		FORMAT_ALWAYS_INLINE basic_format(const char* form, char* buff, uint32_t size, bool append = false) noexcept :
+			format_core(form)
 		{
+			if(!chaout_.set(buff, size)) {
+				error_ = error::out_null;
+			}
+			if(!append) {
+				chaout_.clear();
+
+			}
+			seg_init_();
 			next_();
+			seg_end_();
 		}
 
 
+#ifndef NO_RESUME_FORM
 		//-----------------------------------------------------------------//
 		/*!
-			@brief  コンストラクター
+			@brief  コンストラクター（中断、再開） @n
+					※文字バッファが一杯になると、error::out_overflow で中断し、位置を st に記録する。 @n
+					※文字バッファを送出した後、同じ式を st と共に再度評価すると、続きを出力する。
 			@param[in]	form	フォーマット式
 			@param[in]	buff	文字バッファ
 			@param[in]	size	文字バッファサイズ
+			@param[in]	st		中断、再開の状態
 			@param[in]	append	文字バッファに追加する場合「true」
 		*/
 		//-----------------------------------------------------------------//
-		basic_format(const char* form, char* buff, uint32_t size, bool append = false) noexcept :
-			form_(form),
-			num_(0), point_(0),
-			bitlen_(0),
-			error_(error::none),
-			mode_(mode::NONE), zerosupp_(false), sign_(false), nega_(false)
+		basic_format(const char* form, char* buff, uint32_t size, resume_state& st, bool append = false) noexcept :
+			format_core(form)
 		{
+			static_assert(resume_enable_,
+				"utils::basic_format: resume requires overflow() and skip() of output functor");
+			rsm_.st = &st;
 			if(!chaout_.set(buff, size)) {
 				error_ = error::out_null;
 			}
@@ -1120,34 +4544,57 @@ namespace utils {
 				chaout_.clear();
 
 			}
+			seg_init_();
 			next_();
+			seg_end_();
 		}
+#endif
 
 
 		//-----------------------------------------------------------------//
 		/*!
-			@brief  出力ファンクタの参照
+			@brief  出力ファンクタの参照 @n
+					※出力ファンクタを自分で持つ場合（array_chaout、file_chaout など）は無い（at_chaout を使う）。
 			@return 出力ファンクタ
 		*/
 		//-----------------------------------------------------------------//
+		template <class C = CHAOUT, typename std::enable_if<!is_chaout_local<C>::value, int>::type = 0>
 		static CHAOUT& chaout() noexcept { return chaout_; }
 
 
 		//-----------------------------------------------------------------//
 		/*!
-			@brief  フラッシュ要求（出力ファンクタに対する）
+			@brief  出力ファンクタの参照（自分で持つ場合は、それを返す）
+			@return 出力ファンクタ
+		*/
+		//-----------------------------------------------------------------//
+		constexpr const CHAOUT& at_chaout() const noexcept { return out_(); }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  フラッシュ要求（出力ファンクタに対する） @n
+					※出力ファンクタを自分で持つ場合は無い。
 		*/
 		//-----------------------------------------------------------------//
+		template <class C = CHAOUT, typename std::enable_if<!is_chaout_local<C>::value, int>::type = 0>
 		static void flush() noexcept { return chaout_.flush(); }
 
 
 		//-----------------------------------------------------------------//
 		/*!
-			@brief  エラー種別を返す
+			@brief  エラー種別を返す @n
+					※この式で出力先が溢れた場合は error::out_overflow（変換は最後まで行われる） @n
+					（出力ファンクタが lost() を持つ場合、以前の式で溢れた分は含まない）
 			@return エラー
 		*/
 		//-----------------------------------------------------------------//
-		error get_error() const noexcept { return error_; }
+		constexpr error get_error() const noexcept {
+			if(error_ == error::none && overflow_()) {
+				return error::out_overflow;
+			}
+			return error_;
+		}
 
 
 		//-----------------------------------------------------------------//
@@ -1156,7 +4603,7 @@ namespace utils {
 			@return 変換が全て正常なら「true」
 		*/
 		//-----------------------------------------------------------------//
-		bool status() const noexcept { return error_ == error::none; }
+		constexpr bool status() const noexcept { return get_error() == error::none; }
 
 
 		//-----------------------------------------------------------------//
@@ -1165,7 +4612,25 @@ namespace utils {
 			@return 出力サイズ
 		*/
 		//-----------------------------------------------------------------//
-		int size() const noexcept { return chaout_.size(); }
+		constexpr int size() const noexcept { return out_().size(); }
+
+
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  全て出力するのに必要なサイズを返す @n
+					※出力先が溢れた場合（error::out_overflow）も、最後まで数える。 @n
+					（中断、再開（resume_state）する場合は、溢れた所で止める） @n
+					※文字バッファには、このサイズ＋１（終端の０）が必要。
+			@return 必要なサイズ
+		*/
+		//-----------------------------------------------------------------//
+		constexpr int required_size() const noexcept {
+			if constexpr (has_chaout_required<CHAOUT>::value) {
+				return out_().required_size();
+			} else {
+				return out_().size();
+			}
+		}
 
 
 		//-----------------------------------------------------------------//
@@ -1177,19 +4642,7 @@ namespace utils {
 		//-----------------------------------------------------------------//
 		basic_format& operator % (const std::string& val) noexcept
 		{
-			if(error_ != error::none) {
-				return *this;
-			}
-
-			if(mode_ == mode::STR) {
-				str_sub_(val.c_str());
-			} else {
-				error_ = error::unknown;
-			}
-
-			reset_();
-			next_();
-			return *this;
+			return arg_(val);
 		}
 
 
@@ -1200,75 +4653,83 @@ namespace utils {
 			@return	自分の参照
 		*/
 		//-----------------------------------------------------------------//
-		basic_format& operator % (const char* val) noexcept
+		constexpr basic_format& operator % (const char* val) noexcept
 		{
-			if(error_ != error::none) {
-				return *this;
-			}
+			return arg_(val);
+		}
 
-			if(mode_ == mode::STR) {
-				str_sub_(val);
-			} else if(mode_ == mode::POINTER) {
-				pointer_(static_cast<const void*>(val));
-			} else {
-				error_ = error::unknown;
-			}
 
-			reset_();
-			next_();
-			return *this;
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  オペレーター「%」(char*)
+			@param[in]	val	値
+			@return	自分の参照
+		*/
+		//-----------------------------------------------------------------//
+		constexpr basic_format& operator % (char* val) noexcept
+		{
+			return arg_(val);
 		}
 
 
 		//-----------------------------------------------------------------//
 		/*!
-			@brief  オペレーター「%」(char*)
+			@brief  オペレーター「%」(std::string&)
 			@param[in]	val	値
 			@return	自分の参照
 		*/
 		//-----------------------------------------------------------------//
-		basic_format& operator % (char* val) noexcept
+		basic_format& operator % (std::string& val) noexcept
 		{
-			if(error_ != error::none) {
-				return *this;
-			}
+			return arg_(val);
+		}
 
-			if(mode_ == mode::STR) {
-				str_sub_(val);
-			} else if(mode_ == mode::POINTER) {
-				pointer_(static_cast<const void*>(val));
-			} else {
-				error_ = error::unknown;
-			}
 
-			reset_();
-			next_();
-			return *this;
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  オペレーター「%」(std::string_view) @n
+					※長さが判っているので、終端の検索を行わない。 @n
+					※ポインターと長さで渡す場合は、std::string_view(ptr, len) を使う。
+			@param[in]	val	値
+			@return	自分の参照
+		*/
+		//-----------------------------------------------------------------//
+		constexpr basic_format& operator % (std::string_view val) noexcept
+		{
+			return arg_(val);
 		}
 
 
 		//-----------------------------------------------------------------//
 		/*!
-			@brief  オペレーター「%」(std::string&)
+			@brief  オペレーター「%」(byte_span) @n
+					※メモリーダンプ「%m」、「%M」
 			@param[in]	val	値
 			@return	自分の参照
 		*/
 		//-----------------------------------------------------------------//
-		basic_format& operator % (std::string& val) noexcept
+		basic_format& operator % (const byte_span& val) noexcept
 		{
-			if(error_ != error::none) {
-				return *this;
-			}
+			return arg_(val);
+		}
 
-			if(mode_ == mode::STR) {
-				str_sub_(val.c_str());
-			} else {
-				error_ = error::unknown;
-			}
 
-			reset_();
-			next_();
-			return *this;
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  オペレーター「%」（ユーザー型、範囲） @n
+					※ユーザー型は、ADL で見つかる format_value、又は format_traits の特殊化を呼ぶ。 @n
+					※範囲は、各要素に同じ書式を適用し、区切り「, 」で出力する（join で指定）。 @n
+					※配列はポインターとして扱うので、範囲として表示する場合 join を使う。
+			@param[in]	val	値
+			@return	自分の参照
+		*/
+		//-----------------------------------------------------------------//
+		template <typename T>
+		typename std::enable_if<is_format_custom<T, context>::value || is_range_join<T>::value ||
+			(is_format_range<T>::value && !std::is_array<T>::value), basic_format&>::type
+			operator % (const T& val) noexcept
+		{
+			return arg_(val);
 		}
 
 
@@ -1282,19 +4743,7 @@ namespace utils {
 		template <typename T>
 		basic_format& operator % (T* val) noexcept
 		{
-			if(error_ != error::none) {
-				return *this;
-			}
-
-			if(mode_ == mode::POINTER) {
-				pointer_(static_cast<const void*>(val));
-			} else {
-				error_ = error::unknown;
-			}
-
-			reset_();
-			next_();
-			return *this;
+			return arg_(val);
 		}
 
 
@@ -1306,65 +4755,218 @@ namespace utils {
 		*/
 		//-----------------------------------------------------------------//
 		template <typename T>
-		basic_format& operator % (T val) noexcept
+		typename std::enable_if<!is_format_custom<T, context>::value && !is_format_range<T>::value &&
+			!is_range_join<T>::value && !std::is_same<T, bool>::value, basic_format&>::type
+			constexpr operator % (T val) noexcept
 		{
-			if(error_ != error::none) {
-				return *this;
-			}
+			return arg_(val);
+		}
+	};
 
-			if constexpr (std::is_integral<T>::value) {
-				if(mode_ == mode::CHA) {
-					auto chn = static_cast<int32_t>(val);
-					if(chn > -128 && chn < 128) {
-						chaout_(chn);
-					} else {  // over range
-						error_ = error::over;
-					}
-				} else {
-					typedef typename std::make_signed<T>::type S;
-					decimal_<S>(val, std::is_signed<T>::value);
-				}
-#ifndef NO_FLOAT_FORM
-			} else if constexpr (std::is_floating_point<T>::value) {
-				if(!set_poi_) point_ = 6;
-				switch(mode_) {
-				case mode::REAL:
-					out_real_(val, 0);
-					break;
-				case mode::EXPONENT_CAPS:
-					out_real_(val, 'E');
-					break;
-				case mode::EXPONENT:
-					out_real_(val, 'e');
-					break;
-				case mode::REAL_AUTO_CAPS:
-					auto_mode_ = true;
-					out_auto_real_(val, 'E');
-					break;
-				case mode::REAL_AUTO:
-					auto_mode_ = true;
-					out_auto_real_(val, 'e');
-					break;
-				default:
-					error_ = error::different;
-					break;
-				}
-#endif
-			} else {
-				error_ = error::unknown;
-			}
+	template <class CHAOUT> CHAOUT basic_format<CHAOUT>::chaout_;
 
-			reset_();
-			next_();
+
+	/// 配列へ出力する format（定数式で変換出来る）
+	template <uint32_t N>
+	using array_format = basic_format<array_chaout<N> >;
+
+
+	// 定数式の中で呼ばれると、コンパイル・エラーになる（変換エラー、配列の溢れ）
+	inline void make_format_failed() noexcept { }
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  変換した文字列を配列で返す（constexpr） @n
+				※constexpr 変数の初期化で使うと、コンパイル時に変換される。 @n
+				※変換エラー、配列の溢れは、コンパイル・エラーになる。 @n
+				（実行時に呼んだ場合は、溢れた所までの文字列を返す） @n
+				※浮動小数点（%f、%e、%g）は、定数式で変換出来ない。
+		@param[in]	form	フォーマット式
+		@param[in]	args	引数
+		@return 文字列（終端の０を含む N バイトの配列）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <uint32_t N, typename... Args>
+	constexpr std::array<char, N> make_format(const char* form, const Args&... args) noexcept
+	{
+		array_format<N> fmt(base_format::constant, form);
+		(fmt % ... % args);
+		if(fmt.get_error() != base_format::error::none) {
+			make_format_failed();
+		}
+		return fmt.at_chaout().array();
+	}
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  format で変換出来る型か検査 @n
+				※basic_format<size_chaout> の operator % が呼べるかで判定（実際の format と同じ）
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class T, class = void>
+	struct is_format_arg : std::false_type { };
+
+	template <class T>
+	struct is_format_arg<T, std::void_t<decltype(std::declval<basic_format<size_chaout>&>() % std::declval<T>())> > :
+		std::true_type { };
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  無効 format クラス（null_chaout の特殊化） @n
+				※フォーマット式の解析、変換を一切行わず、型の検査だけ行う。 @n
+				※全て強制的にインライン展開され、最適化をしない場合でもコードを生成しない。 @n
+				※引数の評価は行われるので、評価も省く場合は FORMAT_LOG を使う。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <>
+	class basic_format<null_chaout> : public base_format {
+
+		static inline null_chaout	chaout_;
+
+	public:
+		FORMAT_ALWAYS_INLINE basic_format(const char* form) noexcept { }
+
+		FORMAT_ALWAYS_INLINE basic_format(const char* form, char* buff, uint32_t size, bool append = false) noexcept { }
+
+		static null_chaout& chaout() noexcept { return chaout_; }
+
+		FORMAT_ALWAYS_INLINE static void flush() noexcept { }
+
+		FORMAT_ALWAYS_INLINE error get_error() const noexcept { return error::none; }
+
+		FORMAT_ALWAYS_INLINE bool status() const noexcept { return true; }
+
+		FORMAT_ALWAYS_INLINE int size() const noexcept { return 0; }
+
+		FORMAT_ALWAYS_INLINE int required_size() const noexcept { return 0; }
+
+		template <typename T>
+		FORMAT_ALWAYS_INLINE basic_format& operator % (T&& val) noexcept
+		{
+			static_assert(is_format_arg<T>::value, "utils::null_format: type not supported by format");
 			return *this;
 		}
 	};
 
-	template <class CHAOUT> CHAOUT basic_format<CHAOUT>::chaout_;
-
+#ifdef FORMAT_FLUSH_STAT
+	typedef basic_format<stdout_buffered_chaout<256, flush_stat> > format;
+#else
 	typedef basic_format<stdout_buffered_chaout<256> > format;
+#endif
 	typedef basic_format<stdout_chaout> nformat;
 	typedef basic_format<memory_chaout> sformat;
 	typedef basic_format<null_chaout> null_format;
 	typedef basic_format<size_chaout> size_format;
+	typedef basic_format<signal_chaout<128> > signal_format;
+	typedef basic_format<file_chaout> file_format;
+#ifdef USE_STREAM_FORM
+	typedef basic_format<streambuf_chaout> stream_format;
+#endif
+
+
+	inline void flush_stat::dump(int fd) const noexcept
+	{
+		auto out = [fd](const array_format<96>& f) {
+			auto p = f.at_chaout().c_str();
+			uint32_t n = f.size();
+			while(n > 0) {
+				auto ret = ::write(fd, p, n);
+				if(ret < 0) {
+					if(errno == EINTR) continue;
+					break;
+				}
+				p += ret;
+				n -= static_cast<uint32_t>(ret);
+			}
+		};
+		out(array_format<96>(base_format::constant, "flush: %u (newline %u, full %u, request %u)\n")
+			% flushes % newline % full % request);
+		out(array_format<96>(base_format::constant, "write: %u (short %u, error %u), %u bytes, %u ns\n")
+			% writes % shorts % errors % bytes % write_ns);
+		for(uint32_t i = 0; i < HIST_NUM; ++i) {
+			if(hist[i] == 0) continue;
+			if(i == (HIST_NUM - 1)) {
+				out(array_format<96>(base_format::constant, "  %5u -      : %u\n") % (1u << i) % hist[i]);
+			} else {
+				out(array_format<96>(base_format::constant, "  %5u - %5u: %u\n") % (1u << i) % ((2u << i) - 1) % hist[i]);
+			}
+		}
+	}
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  ログのレベル
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	enum class log_level : uint8_t {
+		none,	///< 出力しない
+		error,	///< エラー
+		warn,	///< 警告
+		info,	///< 情報
+		debug,	///< デバッグ
+		trace,	///< トレース
+	};
+
+	/// 実行時のレベル（これより大きいレベルは、引数の評価、変換を行わない）
+	inline std::atomic<log_level> log_level_{ static_cast<log_level>(FORMAT_LOG_LEVEL) };
+
+
+	//-----------------------------------------------------------------//
+	/*!
+		@brief  実行時のログのレベルを設定
+		@param[in]	lvl	レベル
+	*/
+	//-----------------------------------------------------------------//
+	inline void set_log_level(log_level lvl) noexcept { log_level_.store(lvl, std::memory_order_relaxed); }
+
+
+	//-----------------------------------------------------------------//
+	/*!
+		@brief  実行時のログのレベルを取得
+		@return レベル
+	*/
+	//-----------------------------------------------------------------//
+	inline log_level get_log_level() noexcept { return log_level_.load(std::memory_order_relaxed); }
+
+
+	//-----------------------------------------------------------------//
+	/*!
+		@brief  ログのレベルが有効か検査
+		@param[in]	lvl	レベル
+		@return 有効なら「true」
+	*/
+	//-----------------------------------------------------------------//
+	inline bool log_enable(log_level lvl) noexcept { return lvl <= get_log_level(); }
 }
+
+
+//-----------------------------------------------------------------//
+/*!
+	@brief  レベル付きのログ出力 @n
+			FORMAT_LOG_WITH(utils::sformat, utils::log_level::debug, "%d\n", buff, sizeof(buff)) % a; @n
+			※コンパイル時のレベル（FORMAT_LOG_LEVEL）より大きい場合、コードを生成しない。 @n
+			※実行時のレベルより大きい場合、分岐一つで、format の生成、引数の評価を行わない。 @n
+			※if、else の中で使っても、else の対応は変わらない。
+	@param[in]	FMT	format 型
+	@param[in]	LVL	レベル（定数）
+*/
+//-----------------------------------------------------------------//
+#define FORMAT_LOG_WITH(FMT, LVL, ...) \
+	if constexpr (static_cast<uint8_t>(LVL) > FORMAT_LOG_LEVEL) { } \
+	else if(!utils::log_enable(LVL)) { } \
+	else FMT(__VA_ARGS__)
+
+
+//-----------------------------------------------------------------//
+/*!
+	@brief  レベル付きのログ出力（utils::format） @n
+			FORMAT_LOG(utils::log_level::info, "%d\n") % a;
+	@param[in]	LVL		レベル（定数）
+	@param[in]	FORM	フォーマット式
+*/
+//-----------------------------------------------------------------//
+#define FORMAT_LOG(LVL, FORM) FORMAT_LOG_WITH(utils::format, LVL, FORM)
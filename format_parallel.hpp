@@ -0,0 +1,296 @@
+#pragma once
+//=============================================================================//
+/*! @file
+    @brief  utils::format 並列変換 @n
+			・大量のレコードを、複数のスレッドでチャンク（レコードの塊）毎に変換し、 @n
+			元の順番で出力する。 @n
+			・各スレッドは、自分のチャンク・バッファ（chunk_chaout）に変換するので、 @n
+			basic_format の静的な出力ファンクタを共有しない。 @n
+			・変換中のチャンク数は「window」で制限され、メモリ使用量は一定になる。 @n
+			・ファイル・ディスクリプタへの出力は、完成した連続するチャンクを writev でまとめて書き込む。 @n
+			※スレッドを使うので、format.hpp とは別のヘッダーにしている。
+    @author 平松邦仁 (hira@rvf-rc45.net)
+	@copyright	Copyright (C) 2026 Kunihito Hiramatsu @n
+				Released under the MIT license @n
+				https://github.com/hirakuni45/RX/blob/master/LICENSE
+*/
+//=============================================================================//
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
+#include <climits>
+#include <algorithm>
+#include <cerrno>
+#include <sys/uio.h>
+#include "format.hpp"
+
+namespace utils {
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  チャンク出力ファンクタ @n
+				※出力先はスレッド毎（thread_local）に設定される。 @n
+				※出力先が設定されていない場合、文字は捨てられる。
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct chunk_chaout {
+
+		typedef unsigned int uint;
+
+	private:
+		static inline thread_local std::string*	dst_ = nullptr;
+
+	public:
+		//-----------------------------------------------------------------//
+		/*!
+			@brief  出力先を設定（呼び出したスレッドのみ）
+			@param[in]	dst	出力先（nullptr で解除）
+		*/
+		//-----------------------------------------------------------------//
+		static void set(std::string* dst) noexcept { dst_ = dst; }
+
+		void operator() (char ch) noexcept {
+			if(dst_ != nullptr) {
+				dst_->push_back(ch);
+			}
+		}
+
+		void write(const char* s, uint n) noexcept {
+			if(dst_ != nullptr) {
+				dst_->append(s, n);
+			}
+		}
+
+		void clear() noexcept {
+			if(dst_ != nullptr) {
+				dst_->clear();
+			}
+		}
+
+		/// 現在のチャンクのサイズ
+		uint size() const noexcept { return dst_ != nullptr ? dst_->size() : 0; }
+	};
+
+	typedef basic_format<chunk_chaout> chunk_format;
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  並列変換の設定
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	struct parallel_config {
+		uint32_t	threads;	///< 変換スレッド数（0 の場合、ハードウェアのスレッド数）
+		uint32_t	records;	///< チャンク当たりのレコード数
+		uint32_t	window;		///< 同時に保持するチャンクの最大数（0 の場合、スレッド数の２倍）
+
+		parallel_config(uint32_t threads_ = 0, uint32_t records_ = 1024, uint32_t window_ = 0) noexcept :
+			threads(threads_), records(records_), window(window_) { }
+	};
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  並列変換の本体 @n
+				※func はレコード毎に変換スレッドで呼ばれ、chunk_format で出力する。 @n
+				※drain は呼び出したスレッドで、完成したチャンクを元の順番で受け取る。 @n
+				※drain が「false」を返すと、変換を中断する。
+		@param[in]	first	レコードの先頭（ランダムアクセス・イテレーター）
+		@param[in]	last	レコードの終端
+		@param[in]	func	変換関数 func(const record&)
+		@param[in]	drain	出力関数 drain(const std::string* const* chunks, uint32_t n)
+		@param[in]	cfg		設定
+		@return 全て出力出来た場合「true」
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class IT, class FUNC, class DRAIN>
+	bool parallel_format_chunks(IT first, IT last, FUNC func, DRAIN drain, const parallel_config& cfg = parallel_config())
+	{
+		static_assert(std::is_base_of<std::random_access_iterator_tag,
+			typename std::iterator_traits<IT>::iterator_category>::value,
+			"utils::parallel_format: random access iterator required");
+
+		const size_t total = static_cast<size_t>(last - first);
+		const size_t recs = cfg.records > 0 ? cfg.records : 1;
+		const size_t chunks = (total + recs - 1) / recs;
+		uint32_t threads = cfg.threads;
+		if(threads == 0) {
+			threads = std::thread::hardware_concurrency();
+			if(threads == 0) {
+				threads = 1;
+			}
+		}
+		if(threads > chunks) {
+			threads = static_cast<uint32_t>(chunks);
+		}
+		uint32_t window = cfg.window > 0 ? cfg.window : threads * 2;
+		if(window > chunks) {
+			window = static_cast<uint32_t>(chunks);
+		}
+
+		auto fill = [&](std::string& s, size_t idx) {
+			s.clear();
+			chunk_chaout::set(&s);
+			auto it = first + idx * recs;
+			auto end = (idx + 1) * recs < total ? first + (idx + 1) * recs : last;
+			for(; it != end; ++it) {
+				func(*it);
+			}
+			chunk_chaout::set(nullptr);
+		};
+
+		// スレッドを使う必要が無い場合、呼び出したスレッドで変換
+		if(threads <= 1) {
+			std::string s;
+			const std::string* p = &s;
+			for(size_t i = 0; i < chunks; ++i) {
+				fill(s, i);
+				if(!drain(&p, 1)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::vector<std::string> slot(window);
+		std::vector<char> ready(window, 0);
+		std::vector<const std::string*> list(window);
+		std::mutex mtx;
+		std::condition_variable work_cv;
+		std::condition_variable done_cv;
+		size_t next = 0;	// 次に変換するチャンク
+		size_t done = 0;	// 出力済みのチャンク
+		bool abort = false;
+
+		auto worker = [&]() {
+			std::unique_lock<std::mutex> lk(mtx);
+			for(;;) {
+				work_cv.wait(lk, [&]() { return abort || next >= chunks || next < (done + window); });
+				if(abort || next >= chunks) {
+					break;
+				}
+				auto idx = next++;
+				lk.unlock();
+				fill(slot[idx % window], idx);
+				lk.lock();
+				ready[idx % window] = 1;
+				if(idx == done) {
+					done_cv.notify_one();
+				}
+			}
+		};
+
+		std::vector<std::thread> pool;
+		pool.reserve(threads);
+		for(uint32_t i = 0; i < threads; ++i) {
+			pool.emplace_back(worker);
+		}
+
+		bool ok = true;
+		std::unique_lock<std::mutex> lk(mtx);
+		while(done < chunks) {
+			done_cv.wait(lk, [&]() { return ready[done % window] != 0; });
+			// 完成している連続したチャンクをまとめて出力
+			uint32_t n = 0;
+			while((done + n) < chunks && n < window && ready[(done + n) % window] != 0) {
+				list[n] = &slot[(done + n) % window];
+				++n;
+			}
+			lk.unlock();
+			ok = drain(list.data(), n);
+			lk.lock();
+			for(uint32_t i = 0; i < n; ++i) {
+				ready[(done + i) % window] = 0;
+			}
+			done += n;
+			if(!ok) {
+				abort = true;
+			}
+			work_cv.notify_all();
+			if(!ok) {
+				break;
+			}
+		}
+		lk.unlock();
+
+		for(auto& t : pool) {
+			t.join();
+		}
+		return ok;
+	}
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  並列変換（チャンク毎に出力関数を呼ぶ）
+		@param[in]	first	レコードの先頭（ランダムアクセス・イテレーター）
+		@param[in]	last	レコードの終端
+		@param[in]	func	変換関数 func(const record&)
+		@param[in]	out		出力関数 bool out(const char* s, size_t n)
+		@param[in]	cfg		設定
+		@return 全て出力出来た場合「true」
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class IT, class FUNC, class OUT>
+	bool parallel_format(IT first, IT last, FUNC func, OUT out, const parallel_config& cfg = parallel_config())
+	{
+		return parallel_format_chunks(first, last, func, [&out](const std::string* const* chunks, uint32_t n) {
+			for(uint32_t i = 0; i < n; ++i) {
+				if(!out(chunks[i]->data(), chunks[i]->size())) {
+					return false;
+				}
+			}
+			return true;
+		}, cfg);
+	}
+
+
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	/*!
+		@brief  並列変換（ファイル・ディスクリプタへ writev で出力）
+		@param[in]	fd		ファイル・ディスクリプタ
+		@param[in]	first	レコードの先頭（ランダムアクセス・イテレーター）
+		@param[in]	last	レコードの終端
+		@param[in]	func	変換関数 func(const record&)
+		@param[in]	cfg		設定
+		@return 全て書き込めた場合「true」
+	*/
+	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++//
+	template <class IT, class FUNC>
+	bool parallel_format(int fd, IT first, IT last, FUNC func, const parallel_config& cfg = parallel_config())
+	{
+		std::vector<iovec> iov;
+		return parallel_format_chunks(first, last, func, [fd, &iov](const std::string* const* chunks, uint32_t n) {
+			iov.clear();
+			for(uint32_t i = 0; i < n; ++i) {
+				if(!chunks[i]->empty()) {
+					iov.push_back(iovec{ const_cast<char*>(chunks[i]->data()), chunks[i]->size() });
+				}
+			}
+			size_t pos = 0;
+			while(pos < iov.size()) {
+				int cnt = static_cast<int>(std::min(iov.size() - pos, static_cast<size_t>(IOV_MAX)));
+				auto ret = ::writev(fd, &iov[pos], cnt);
+				if(ret < 0) {
+					if(errno == EINTR) {
+						continue;
+					}
+					return false;
+				}
+				// 書き込めた分だけ進める（部分書き込み）
+				auto len = static_cast<size_t>(ret);
+				while(pos < iov.size() && len >= iov[pos].iov_len) {
+					len -= iov[pos].iov_len;
+					++pos;
+				}
+				if(len > 0) {
+					iov[pos].iov_base = static_cast<char*>(iov[pos].iov_base) + len;
+					iov[pos].iov_len -= len;
+				}
+			}
+			return true;
+		}, cfg);
+	}
+}
@@ -8,13 +8,31 @@
 */
 //=============================================================================//
 #include <iostream>
+#include <sstream>
 #include <boost/format.hpp>
 #include <limits>
 #include <cmath>
+#include <vector>
+#include <array>
+#include <ctime>
+#include <chrono>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <thread>
+#include <atomic>
 
 // mingw64 環境では、標準の「write」関数より「putchar」を使った方が高速です。
 #define USE_PUTCHAR
+// ログ出力の検査用（trace はコードを生成しない）
+#define FORMAT_LOG_LEVEL 4
+// 文字列のエスケープ（%js、%vs）を検査する
+#define USE_ESCAPE_FORM
+// std::streambuf への出力（stream_format）を検査する
+#define USE_STREAM_FORM
 #include "format.hpp"
+#include "format_parallel.hpp"
 
 namespace {
 
@@ -116,6 +134,110 @@ namespace {
 		return ret;
 	} 
 
+	// ユーザー型の変換検査用（ADL で見つかる format_value）
+	enum class color { red, green, blue };
+
+	template <class CTX>
+	void format_value(CTX& ctx, color c)
+	{
+		static const char* name[] = { "red", "green", "blue" };
+		if(ctx.type() == 's') {
+			ctx.out(name[static_cast<int>(c)]);
+		} else if(ctx.type() == 'd') {
+			ctx.format("%d") % static_cast<int>(c);
+		} else {
+			ctx.set_error(utils::format::error::different);
+		}
+	}
+
+	// 静的な出力ファンクタの参照（chaout()）を持つか
+	template <class FMT, class = void>
+	struct has_static_chaout : std::false_type { };
+
+	template <class FMT>
+	struct has_static_chaout<FMT, std::void_t<decltype(FMT::chaout())> > : std::true_type { };
+
+	// sformat で「%」が呼べるか（is_format_arg との比較用）
+	template <class T, class = void>
+	struct can_sformat : std::false_type { };
+
+	template <class T>
+	struct can_sformat<T, std::void_t<decltype(std::declval<utils::sformat&>() % std::declval<T>())> > : std::true_type { };
+
+	template <class T>
+	constexpr bool same_format_arg() { return utils::is_format_arg<T>::value == can_sformat<T>::value; }
+
+	enum plain_enum { plain_a, plain_b };
+	enum class scoped_enum { a, b };
+
+	struct vec3 {
+		int	x;
+		int	y;
+		int	z;
+	};
+
+	template <class CTX>
+	void format_value(CTX& ctx, const vec3& v)
+	{
+		ctx.format("(%d, %d, %d)") % v.x % v.y % v.z;
+	}
+
+	// ユーザー型の変換検査用（format_traits の特殊化）
+	struct money {
+		int32_t	cent;
+	};
+
+	// 中断、再開の検査用（変換回数を数える）
+	struct conv_count {
+		const char*	str;
+	};
+	int conv_count_num = 0;
+
+	template <class CTX>
+	void format_value(CTX& ctx, const conv_count& v)
+	{
+		++conv_count_num;
+		ctx.out(v.str);
+	}
+
+	// シグナル・ハンドラーの検査用（変換の途中でシグナルを発生させる）
+	struct raise_sig {
+		int	sig;
+	};
+
+	template <class CTX>
+	void format_value(CTX& ctx, const raise_sig& v)
+	{
+		ctx.write("[", 1);
+		std::raise(v.sig);
+		ctx.write("]", 1);
+	}
+
+	int sig_fd_ = -1;
+
+	void sig_handler_(int sig)
+	{
+		utils::signal_format(sig_fd_, "handler: %5d %08X %p %s\n") % -123 % 0xbeefu % reinterpret_cast<void*>(0x1234) % "in handler";
+	}
+
+	std::string read_all_(int fd)
+	{
+		std::string res;
+		char tmp[256];
+		ssize_t n;
+		while((n = read(fd, tmp, sizeof(tmp))) > 0) res.append(tmp, n);
+		return res;
+	}
+
+	// 分配出力ファンクタの検査用（ブロック出力を持たない出力ファンクタ）
+	struct count_chaout {
+		typedef unsigned int uint;
+		uint	n = 0;
+		void operator () (char ch) noexcept { ++n; }
+		void clear() noexcept { n = 0; }
+		uint size() const noexcept { return n; }
+	};
+
 	// 速度検査用
 	void test_speed_(const std::string& s, long count)
 	{
@@ -140,6 +262,29 @@ namespace {
 	}
 }
 
+namespace utils {
+
+	template <>
+	struct format_traits<money> {
+		template <class CTX>
+		static void format(CTX& ctx, const money& m)
+		{
+			char tmp[16];
+			char* out = &tmp[sizeof(tmp)];
+			uint32_t v = m.cent < 0 ? -m.cent : m.cent;
+			for(int i = 0; i < 3 || v != 0; ++i) {
+				if(i == 2) *--out = '.';
+				*--out = (v % 10) + '0';
+				v /= 10;
+			}
+			char sign = 0;
+			if(m.cent < 0) sign = '-';
+			else if(ctx.sign()) sign = '+';
+			ctx.out(out, &tmp[sizeof(tmp)] - out, sign);
+		}
+	};
+}
+
 static constexpr long speed_count_ = 500000;
 
 int main(int argc, char* argv[]);
@@ -150,7 +295,7 @@ int main(int argc, char* argv[])
 
 	int pass = 0;
 	int total = 0;
-	uint32_t exec = 0b1111'1111'1111'1111'1111'1111'1111;
+	uint64_t exec = ~static_cast<uint64_t>(0);
 
 	bool start = false;
 	if(argc > 1) {
@@ -168,12 +313,12 @@ int main(int argc, char* argv[])
 				test_speed_("format", speed_count_);
 			} else if(s[0] == '-') {
 				auto n = std::stoi(argv[i] + 1);
-				if(n >= 1 && n <= 32) {
+				if(n >= 1 && n <= 64) {
 					if(!init) {
 						exec = 0;
 						init = true;
 					}
-					exec |= 1 << (n - 1);
+					exec |= 1ull << (n - 1);
 				}
 			}
 		}
@@ -185,18 +330,18 @@ int main(int argc, char* argv[])
 		std::cout << "    -printf    Speed test 'printf'" << std::endl;
 		std::cout << "    -boost     Speed test 'boost' (iostream)" << std::endl;
 		std::cout << "    -format    Speed test 'format'" << std::endl;
-		std::cout << "    -(1 to 32) Select single test (1 to 32)" << std::endl;
+		std::cout << "    -(1 to 64) Select single test (1 to 64)" << std::endl;
 		return 0;
 	}
 
-	if(exec & (1 << 0)) {  // Test01: 文字列制限の検査
+	if(exec & (1ull << 0)) {  // Test01: 文字列制限の検査
 		char res[16];
 		memset(res, '.', 16);
 		int size = 8;
 		static const char* ref = { "0123456789" };
 		auto err = (utils::sformat("%s", res, size) % ref).get_error();
 		bool ef = true;
-		if(err == format::error::none && strncmp(ref, res, size - 1) == 0
+		if(err == format::error::out_overflow && strncmp(ref, res, size - 1) == 0
 			&& res[size - 1] == 0 && res[size] == '.') {
 			ef = false;
 		}
@@ -204,7 +349,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 1)) {  // Test02: %d の 数値をデコードする検査
+	if(exec & (1ull << 1)) {  // Test02: %d の 数値をデコードする検査
 		int a = 12345678;
 		static const char* form[] = {
 			"form=%d", "form=%13d", "form=%012d", "form=%6d", "form=%07d"
@@ -226,7 +371,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 2)) {  // Test03: %o の 数値をデコードする検査
+	if(exec & (1ull << 2)) {  // Test03: %o の 数値をデコードする検査
 		uint32_t a = 01245667;
 		static const char* form[] = {
 			"form=%o", "form=%10o", "form=%09o", "form=%6o", "form=%07o"
@@ -247,7 +392,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 3)) {  // Test04: %b の 数値をデコードする検査
+	if(exec & (1ull << 3)) {  // Test04: %b の 数値をデコードする検査
 		int a = 0b10101110;
 		static const char* form[] = {
 			"form=%b", "form=%12b", "form=%013b", "form=%6b", "form=%07b"
@@ -269,7 +414,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 4)) {  // Test05: %x, %X の 数値をデコードする検査
+	if(exec & (1ull << 4)) {  // Test05: %x, %X の 数値をデコードする検査
 		uint32_t a = 0x12A4BF9C;
 		static const char* form[] = {
 			"form=%x", "form=%10x", "form=%09x", "form=%6x", "form=%07x",
@@ -291,7 +436,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 5)) {  // Test06: %u の 数値をデコードする検査
+	if(exec & (1ull << 5)) {  // Test06: %u の 数値をデコードする検査
 		int a = 12345678;
 		static const char* form[] = {
 			"form=%u", "form=%13u", "form=%012u", "form=%6u", "form=%07u"
@@ -313,7 +458,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 6)) {  // Test07: %f の 数値をデコードする検査
+	if(exec & (1ull << 6)) {  // Test07: %f の 数値をデコードする検査
 		float a = sqrtf(5.0f);
 		static const char* form[] = {
 			"form=%f", "form=%9.8f", "form=%07.6f", "form=%5.4f", "form=%05.4f", "form=%6.0f"
@@ -335,7 +480,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 7)) {  // Test08: %e の 数値をデコードする検査
+	if(exec & (1ull << 7)) {  // Test08: %e の 数値をデコードする検査
 		float a[] = { 102500.125f, 0.0000000325f, -107500.125f, -0.0000000625f };
 		static const char* form[] = {
 			"form=%e", "form=%7.6e", "form=%07.6e", "form=%5.4e", "form=%05.4e",
@@ -356,7 +501,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 8)) {  // Test09: %s の 文字列をデコードする検査
+	if(exec & (1ull << 8)) {  // Test09: %s の 文字列をデコードする検査
 		static const char* inp = {
 			"AbcdEFG"
 		};
@@ -379,13 +524,13 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 9)) {  // Test10: フォーマットに nullptr を与えた場合のエラー検査。
+	if(exec & (1ull << 9)) {  // Test10: フォーマットに nullptr を与えた場合のエラー検査。
 		auto err = (utils::format(nullptr)).get_error();
 		pass += list_result_(total + 1, 1, 1, "format poniter to nullptr, error code check. ", "format error code fail.", err != format::error::null);
 		++total;
 	}
 
-	if(exec & (1 << 10)) {  // Test11: 型が異なる場合のエラー検査。（different エラーになる事を確認）
+	if(exec & (1ull << 10)) {  // Test11: 型が異なる場合のエラー検査。（different エラーになる事を確認）
 		float a = 0.0f;
 		static const char* form[] = { "%s", "%d", "%c", "%u", "%p" };
 		int sub = 0;
@@ -402,7 +547,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 11)) {  // Test12: ポインター型検査。
+	if(exec & (1ull << 11)) {  // Test12: ポインター型検査。
 		float a = 0.0f;
 		static const char* form = { "%p" };
 		char res[64];
@@ -413,7 +558,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 12)) {  // Test13: 浮動小数点、inf 表現検査。
+	if(exec & (1ull << 12)) {  // Test13: 浮動小数点、inf 表現検査。
 		float inf = std::numeric_limits<float>::infinity();
 		static const char* form = { "%f" };
 		char res[64];
@@ -424,7 +569,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 13)) {  // Test14: 型が異なる場合に適切にエラーになるか検査。
+	if(exec & (1ull << 13)) {  // Test14: 型が異なる場合に適切にエラーになるか検査。
 		int a = 0;
 		static const char* form[] = { "%s", "%f", "%p", "%g" };
 		int sub = 0;
@@ -441,7 +586,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 14)) {  // Test15: %y 固定小数点の検査（１０ビット）
+	if(exec & (1ull << 14)) {  // Test15: %y 固定小数点の検査（１０ビット）
 		static const uint16_t val[] = { 17, 61, 100, 500, 750, 896, 1000, 1024 };
 		int sub = 0;
 		int num = 8;
@@ -460,7 +605,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 15)) {  // Test16: %7.6f -1 表示
+	if(exec & (1ull << 15)) {  // Test16: %7.6f -1 表示
 		char res[64];
 		float val = -99.0f;
 		auto err = (sformat("%7.6f", res, sizeof(res)) % val).get_error();
@@ -470,7 +615,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 16)) {  // Test17: %-7.6f -1 表示
+	if(exec & (1ull << 16)) {  // Test17: %-7.6f -1 表示
 		char res[64];
 		float val = -99.0f;
 		auto err = (sformat("%-7.6f", res, sizeof(res)) % val).get_error();
@@ -480,7 +625,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 17)) {  // Test18: ポインターアドレス表示 (char*)
+	if(exec & (1ull << 17)) {  // Test18: ポインターアドレス表示 (char*)
 		char res[64];
 		static const char* val = res;
 		auto err = (sformat("%p", res, sizeof(res)) % val).get_error();
@@ -490,7 +635,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 18)) {  // Test19: ポインターアドレス表示 (int*)
+	if(exec & (1ull << 18)) {  // Test19: ポインターアドレス表示 (int*)
 		char res[64];
 		static const int dec = 1234;
 		static const int* val = &dec;
@@ -501,7 +646,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 19)) {  // Test20: %g 表示
+	if(exec & (1ull << 19)) {  // Test20: %g 表示
 		int sub = 0;
 		static const char* form[] = { "%g", "%G" };
 		int num = 22;
@@ -521,7 +666,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 20)) {  // Test21: %8g 表示
+	if(exec & (1ull << 20)) {  // Test21: %8g 表示
 		int sub = 0;
 		static const char* form[] = { "%8g", "%8G" };
 		int num = 22;
@@ -542,7 +687,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 21)) {  // Test22: 浮動小数点、nan 表現検査。
+	if(exec & (1ull << 21)) {  // Test22: 浮動小数点、nan 表現検査。
 		float inf = std::numeric_limits<float>::infinity();
 		static const char* form = { "%6.3f" };
 		float nan = inf - inf;
@@ -554,7 +699,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 22)) {  // Test23: %% の表示検査
+	if(exec & (1ull << 22)) {  // Test23: %% の表示検査
 		static const char* form = { "%dabcdefg%%ABCDEFG%d" };
 		int a = 1234;
 		int b = 5678;
@@ -566,7 +711,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 23)) {  // Test24: %q の表示検査（仕様に無い文字の挙動）
+	if(exec & (1ull << 23)) {  // Test24: %q の表示検査（仕様に無い文字の挙動）
 		static const char* form = { "aaa %q bbb" };
 		char res[32];
 		int a = 100;
@@ -577,7 +722,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 24)) {  // Test25: 64 bits 2 進数の検査
+	if(exec & (1ull << 24)) {  // Test25: 64 bits 2 進数の検査
 		uint64_t a = 0b1101'1001'1011'0111'0010'1011'0101'1010'1110;
 		static const char* form[] = {
 			"form=%b", "form=%39b", "form=%038b", "form=%37b", "form=%033b"
@@ -602,7 +747,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 25)) {  // Test26: 64 bits 10 進数の検査
+	if(exec & (1ull << 25)) {  // Test26: 64 bits 10 進数の検査
 		static const char* form[] = {
 			"form=%d", "form=%20d", "form=%025d", "form=%20d", "form=%17d",
 		};
@@ -627,7 +772,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 26)) {  // Test27: 64 bits 16 進数の検査
+	if(exec & (1ull << 26)) {  // Test27: 64 bits 16 進数の検査
 		uint64_t a = 0x567f'12A4'BF9C;
 		static const char* form[] = {
 			"form=%x", "form=%14x", "form=%015x", "form=%7x", "form=%07x",
@@ -652,7 +797,7 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
-	if(exec & (1 << 27)) {  // Test28: 多数桁指定の確認
+	if(exec & (1ull << 27)) {  // Test28: 多数桁指定の確認
 		int j = 1234567;
 		static const char* form[] = {
 			"%0130d", "%130d",
@@ -673,6 +818,1056 @@ int main(int argc, char* argv[])
 		++total;
 	}
 
+	if(exec & (1ull << 28)) {  // Test29: 文字列の長さ指定（std::string_view, %.Ns）の検査
+		static const char* inp = { "AbcdEFGhij" };
+		static const char* form[] = {
+			"%s", "%.3s", "%10.3s", "%-10.3s", "%.20s", "%.0s"
+		};
+		// 終端が無いバッファ（%.Ns では N 文字を超えて参照しない）
+		static const char nterm[4] = { 'W', 'X', 'Y', 'Z' };
+		int sub = 0;
+		int num = 6 * 3 + 1;
+		int idx = 0;
+		for(int i = 0; i < 6; ++i) {
+			char ref[64];
+			sprintf(ref, form[i], inp);
+			char res[64];
+			auto err = (sformat(form[i], res, sizeof(res)) % inp).get_error();
+			sub += list_result_(total + 1, ++idx, num, "string precision check. ", ref, res, err);
+			std::string str = inp;
+			err = (sformat(form[i], res, sizeof(res)) % str).get_error();
+			sub += list_result_(total + 1, ++idx, num, "std::string precision check. ", ref, res, err);
+			// 部分文字列 "cdEF"
+			std::string_view sv(inp + 2, 4);
+			sprintf(ref, form[i], std::string(sv).c_str());
+			err = (sformat(form[i], res, sizeof(res)) % sv).get_error();
+			sub += list_result_(total + 1, ++idx, num, "std::string_view check. ", ref, res, err);
+		}
+		{
+			char res[64];
+			auto err = (sformat("[%.4s]", res, sizeof(res)) % nterm).get_error();
+			sub += list_result_(total + 1, ++idx, num, "no terminate string check. ", "[WXYZ]", res, err);
+		}
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 29)) {  // Test30: メモリーダンプ（%m, %M）の検査
+		static const char hello[] = { "Hello World\n" };
+		uint8_t bin[20];
+		for(int i = 0; i < 20; ++i) bin[i] = i;
+		static const char* ref[] = {
+			"00000000  48 65 6c 6c 6f 20 57 6f  72 6c 64 0a              |Hello World.|\n",
+			"00001000  00 01 02 03 04 05 06 07  08 09 0A 0B 0C 0D 0E 0F  |................|\n"
+			"00001010  10 11 12 13                                       |....|\n",
+			"0000  41 42 43 44  45 46 47 48  |ABCDEFGH|\n"
+			"0008  49 4a                     |IJ|\n",
+		};
+		int sub = 0;
+		int num = 4;
+		char res[256];
+		auto err = (sformat("%m", res, sizeof(res)) % byte_span(hello, sizeof(hello) - 1)).get_error();
+		sub += list_result_(total + 1, 1, num, "memory dump check. ", ref[0], res, err);
+		err = (sformat("%M", res, sizeof(res)) % byte_span(bin, sizeof(bin), 0x1000)).get_error();
+		sub += list_result_(total + 1, 2, num, "memory dump (caps) check. ", ref[1], res, err);
+		err = (sformat("%8.4:4m", res, sizeof(res)) % std::string_view("ABCDEFGHIJ")).get_error();
+		sub += list_result_(total + 1, 3, num, "memory dump (line, group) check. ", ref[2], res, err);
+		err = (sformat("%d", res, sizeof(res)) % byte_span(bin, sizeof(bin))).get_error();
+		sub += list_result_(total + 1, 4, num, "memory dump different type check. ", "error type of different fail.", err != format::error::different);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 30)) {  // Test31: %e、%g の正規化（範囲の端、桁上がり）の検査
+		int sub = 0;
+		static const char* form[] = { "%e", "%.3e", "%E", "%g", "%.1g" };
+		static const float val[] = { 750000.0f, 1e20f, 3e38f, 1e-20f, 9.99999f, 0.00015f, 0.0f, 123456.7f };
+		static constexpr int fn = sizeof(form) / sizeof(form[0]);
+		int num = fn * (sizeof(val) / sizeof(val[0]));
+		for(int i = 0; i < num; ++i) {
+			auto a = val[i / fn];
+			char ref[64];
+			sprintf(ref, form[i % fn], a);
+			char res[64];
+			auto err = (sformat(form[i % fn], res, sizeof(res)) % a).get_error();
+			sub += list_result_(total + 1, i + 1, num, "floating point normalize check. ", ref, res, err);
+		}
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 31)) {  // Test32: ユーザー型の変換（format_value、format_traits）の検査
+		int sub = 0;
+		int num = 8;
+		char res[64];
+		auto err = (sformat("%s", res, sizeof(res)) % color::green).get_error();
+		sub += list_result_(total + 1, 1, num, "user type (ADL) check. ", "green", res, err);
+		err = (sformat("[%-6s]", res, sizeof(res)) % color::red).get_error();
+		sub += list_result_(total + 1, 2, num, "user type (left) check. ", "[red   ]", res, err);
+		err = (sformat("%s:%d", res, sizeof(res)) % color::blue % color::blue).get_error();
+		sub += list_result_(total + 1, 3, num, "user type (type) check. ", "blue:2", res, err);
+		err = (sformat("%s, %d", res, sizeof(res)) % vec3{ 1, -2, 3 } % 4).get_error();
+		sub += list_result_(total + 1, 4, num, "user type (nest) check. ", "(1, -2, 3), 4", res, err);
+		err = (sformat("%9s", res, sizeof(res)) % money{ -12345 }).get_error();
+		sub += list_result_(total + 1, 5, num, "user type (traits) check. ", "  -123.45", res, err);
+		err = (sformat("%+08s", res, sizeof(res)) % money{ 5 }).get_error();
+		sub += list_result_(total + 1, 6, num, "user type (traits zero) check. ", "+0000.05", res, err);
+		err = (sformat("%.2s", res, sizeof(res)) % color::green).get_error();
+		sub += list_result_(total + 1, 7, num, "user type (precision) check. ", "gr", res, err);
+		err = (sformat("%x", res, sizeof(res)) % color::red).get_error();
+		sub += list_result_(total + 1, 8, num, "user type different check. ", "error type of different fail.", err != format::error::different);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 32)) {  // Test33: 範囲（コンテナ）の表示検査
+		int sub = 0;
+		int num = 9;
+		char res[128];
+		std::vector<int> vi = { 1, -2, 3 };
+		auto err = (sformat("%d", res, sizeof(res)) % vi).get_error();
+		sub += list_result_(total + 1, 1, num, "range (vector) check. ", "1, -2, 3", res, err);
+		std::array<uint8_t, 3> ab = { 0x0a, 0xff, 0x00 };
+		err = (sformat("[%02X]", res, sizeof(res)) % utils::join(ab, " ")).get_error();
+		sub += list_result_(total + 1, 2, num, "range (array, join) check. ", "[0A FF 00]", res, err);
+		static const float af[] = { 1.5f, 2.25f, -3.0f };
+		err = (sformat("%5.2f", res, sizeof(res)) % utils::join(af, ",", "{", "}")).get_error();
+		sub += list_result_(total + 1, 3, num, "range (float, brackets) check. ", "{ 1.50, 2.25,-3.00}", res, err);
+		std::vector<std::string> vs = { "ab", "c" };
+		err = (sformat("%-3s", res, sizeof(res)) % utils::join(vs, "|", "<", ">")).get_error();
+		sub += list_result_(total + 1, 4, num, "range (string) check. ", "<ab |c  >", res, err);
+		static const char* an[] = { "x", "y" };
+		std::vector<color> vc = { color::red, color::blue };
+		err = (sformat("%s; %s", res, sizeof(res)) % utils::join(an) % vc).get_error();
+		sub += list_result_(total + 1, 5, num, "range (pointer, user type) check. ", "x, y; red, blue", res, err);
+		std::vector<int> ve;
+		err = (sformat("[%d]:%d", res, sizeof(res)) % utils::join(ve, ",", "(", ")") % 7).get_error();
+		sub += list_result_(total + 1, 6, num, "range (empty) check. ", "[()]:7", res, err);
+		std::vector<int> vh = { 65, 66 };
+		err = (sformat("%c %x", res, sizeof(res)) % vh % utils::join(vh, "")).get_error();
+		sub += list_result_(total + 1, 7, num, "range (char, hex) check. ", "A, B 4142", res, err);
+		std::array<std::vector<int>, 2> vv = { std::vector<int>{ 1, 2 }, std::vector<int>{ 3 } };
+		err = (sformat("%d", res, sizeof(res)) % utils::join(vv, " / ")).get_error();
+		sub += list_result_(total + 1, 8, num, "range (nest) check. ", "1, 2 / 3", res, err);
+		err = (sformat("%s", res, sizeof(res)) % vi).get_error();
+		sub += list_result_(total + 1, 9, num, "range different check. ", "error type of different fail.", err != format::error::different);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 33)) {  // Test34: 時刻表示（%t）の検査
+		auto local = [](time_t t) {
+			struct tm tm;
+			localtime_r(&t, &tm);
+			char tmp[32];
+			strftime(tmp, sizeof(tmp), "%Y-%m-%d %H:%M:%S", &tm);
+			return std::string(tmp);
+		};
+		int sub = 0;
+		int num = 10;
+		char res[128];
+		time_t t0 = 1700000000;
+		auto err = (sformat("%t", res, sizeof(res)) % t0).get_error();
+		sub += list_result_(total + 1, 1, num, "time (time_t) check. ", local(t0), res, err);
+		timespec ts = { t0, 123456789 };
+		err = (sformat("%.3t", res, sizeof(res)) % ts).get_error();
+		sub += list_result_(total + 1, 2, num, "time (timespec) check. ", local(t0) + ".123", res, err);
+		err = (sformat("%.9t", res, sizeof(res)) % ts).get_error();
+		sub += list_result_(total + 1, 3, num, "time (nsec) check. ", local(t0) + ".123456789", res, err);
+		err = (sformat("%24t|", res, sizeof(res)) % t0).get_error();
+		sub += list_result_(total + 1, 4, num, "time (width) check. ", "     " + local(t0) + "|", res, err);
+		err = (sformat("%-21t|", res, sizeof(res)) % t0).get_error();
+		sub += list_result_(total + 1, 5, num, "time (left) check. ", local(t0) + "  |", res, err);
+		auto tp = std::chrono::system_clock::from_time_t(t0 + 1) + std::chrono::milliseconds(250);
+		err = (sformat("%.2t", res, sizeof(res)) % tp).get_error();
+		sub += list_result_(total + 1, 6, num, "time (time_point) check. ", local(t0 + 1) + ".25", res, err);
+		err = (sformat("%t %t", res, sizeof(res)) % t0 % static_cast<time_t>(1)).get_error();
+		sub += list_result_(total + 1, 7, num, "time (cache) check. ", local(t0) + " " + local(1), res, err);
+		err = (sformat("%d", res, sizeof(res)) % ts).get_error();
+		sub += list_result_(total + 1, 8, num, "time different check. ", "error type of different fail.", err != format::error::different);
+		// 変換出来ない時刻（localtime_r の失敗、年が４桁を超える）は、固定の文字列とエラー
+		err = (sformat("%t", res, sizeof(res)) % std::numeric_limits<time_t>::max()).get_error();
+		sub += list_result_(total + 1, 9, num, "time out of range check. ", "0000-00-00 00:00:00", res,
+			err == format::error::over ? format::error::none : format::error::unknown);
+		err = (sformat("%t", res, sizeof(res)) % t0).get_error();
+		sub += list_result_(total + 1, 10, num, "time after fail check. ", local(t0), res, err);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 34)) {  // Test35: 分配出力ファンクタ（tee_chaout）の検査
+		typedef utils::tee_chaout<utils::memory_chaout, utils::memory_chaout, count_chaout> tee;
+		typedef utils::basic_format<tee> tformat;
+		int sub = 0;
+		int num = 7;
+		char buf0[64];
+		char buf1[8];
+		tformat::chaout().at<0>().set(buf0, sizeof(buf0));
+		tformat::chaout().at<1>().set(buf1, sizeof(buf1));
+		auto err = (tformat("%d:%5s\n") % 123 % "abc").get_error();
+		sub += list_result_(total + 1, 1, num, "tee (child 0) check. ", "123:  abc\n", buf0, err);
+		sub += list_result_(total + 1, 2, num, "tee (child 1) check. ", "123:  a", buf1, err);
+		sub += list_result_(total + 1, 3, num, "tee (child 2) check. ", "10", std::to_string(tformat::chaout().at<2>().size()), err);
+		auto& ch = tformat::chaout();
+		sub += list_result_(total + 1, 4, num, "tee error check. ", "error of child fail.",
+			ch.get_error(0) != format::error::none || ch.get_error(1) != format::error::out_overflow ||
+			ch.get_error(2) != format::error::none || ch.get_error() != format::error::out_overflow);
+		ch.clear();
+		err = (tformat("%s%%") % "x").get_error();
+		sub += list_result_(total + 1, 5, num, "tee (clear) check. ", "x%", buf0, err);
+		sub += list_result_(total + 1, 6, num, "tee clear error check. ", "error of child fail.", ch.get_error() != format::error::none);
+		char res[32];
+		err = (sformat("[%d]", res, sizeof(res)) % 1 % 2).get_error();
+		sub += list_result_(total + 1, 7, num, "extra argument check. ", "[1]", res, format::error::none);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 35)) {  // Test36: レベル付きのログ出力（FORMAT_LOG）の検査
+		int sub = 0;
+		int num = 6;
+		char res[32] = { 0 };
+		int cnt = 0;
+		utils::set_log_level(utils::log_level::warn);
+		FORMAT_LOG_WITH(utils::sformat, utils::log_level::info, "%d", res, sizeof(res)) % ++cnt;
+		sub += list_result_(total + 1, 1, num, "log (runtime off) check. ", "output generated.", res[0] != 0);
+		sub += list_result_(total + 1, 2, num, "log (runtime off) argument check. ", "argument evaluated.", cnt != 0);
+		FORMAT_LOG_WITH(utils::sformat, utils::log_level::warn, "%d", res, sizeof(res)) % ++cnt;
+		sub += list_result_(total + 1, 3, num, "log (runtime on) check. ", "1", res, format::error::none);
+		utils::set_log_level(utils::log_level::trace);
+		FORMAT_LOG_WITH(utils::sformat, utils::log_level::trace, "%d", res, sizeof(res)) % ++cnt;
+		sub += list_result_(total + 1, 4, num, "log (compile time off) check. ", "argument evaluated.", cnt != 1);
+		int els = 0;
+		if(cnt == 1)
+			FORMAT_LOG_WITH(utils::sformat, utils::log_level::error, "%d:%d", res, sizeof(res)) % ++cnt % els;
+		else
+			els = 1;
+		sub += list_result_(total + 1, 5, num, "log (if, else) check. ", "2:0", res, format::error::none);
+		sub += list_result_(total + 1, 6, num, "log level check. ", "level fail.", utils::get_log_level() != utils::log_level::trace || els != 0);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 36)) {  // Test37: null_format（特殊化）の検査
+		int sub = 0;
+		int num = 4;
+		std::vector<int> vi = { 1, 2 };
+		auto& f = utils::null_format("%d %s %s %f %p %d %d\n") % 1 % "a" % vi % 1.5f % &num % plain_a % scoped_enum::b;
+		sub += list_result_(total + 1, 1, num, "null_format status check. ", "status fail.", !f.status() || f.get_error() != format::error::none);
+		sub += list_result_(total + 1, 2, num, "null_format size check. ", "size fail.", f.size() != 0 || f.required_size() != 0);
+		bool same = same_format_arg<int>() && same_format_arg<const char*>() && same_format_arg<vec3>() &&
+			same_format_arg<std::pair<int, int> >() && same_format_arg<plain_enum>() && same_format_arg<scoped_enum>() &&
+			same_format_arg<bool>() && same_format_arg<const bool&>();
+		sub += list_result_(total + 1, 3, num, "null_format type check (same as sformat). ", "type check fail.",
+			!same || !utils::is_format_arg<vec3>::value || !utils::is_format_arg<plain_enum>::value ||
+			!utils::is_format_arg<scoped_enum>::value || utils::is_format_arg<bool>::value);
+		char tmp[16];
+		utils::sformat s("%d", tmp, sizeof(tmp));
+		s % plain_b;
+		sub += list_result_(total + 1, 4, num, "sformat enum check. ", "error type of unknown fail.", s.get_error() != format::error::unknown);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 37)) {  // Test38: 並列変換（元の順番で出力）の検査
+		int sub = 0;
+		int num = 4;
+		std::vector<int> rec(10000);
+		for(int i = 0; i < static_cast<int>(rec.size()); ++i) {
+			rec[i] = i * 7 - 3000;
+		}
+		auto func = [](int v) { utils::chunk_format("%d:%04X,") % v % (v & 0xffff); };
+		std::string ref;
+		for(auto v : rec) {
+			char tmp[32];
+			snprintf(tmp, sizeof(tmp), "%d:%04X,", v, v & 0xffff);
+			ref += tmp;
+		}
+		std::string res;
+		auto out = [&res](const char* s, size_t n) { res.append(s, n); return true; };
+		bool ok = utils::parallel_format(rec.begin(), rec.end(), func, out, utils::parallel_config(1, 100));
+		sub += list_result_(total + 1, 1, num, "parallel format (1 thread) check. ", "order fail.", !ok || res != ref);
+		res.clear();
+		ok = utils::parallel_format(rec.begin(), rec.end(), func, out, utils::parallel_config(4, 37, 3));
+		sub += list_result_(total + 1, 2, num, "parallel format (4 threads) check. ", "order fail.", !ok || res != ref);
+		int cnt = 0;
+		ok = utils::parallel_format(rec.begin(), rec.end(), func, [&cnt](const char* s, size_t n) { return ++cnt < 3; },
+			utils::parallel_config(4, 100));
+		sub += list_result_(total + 1, 3, num, "parallel format abort check. ", "abort fail.", ok || cnt != 3);
+		auto fp = tmpfile();
+		ok = fp != nullptr && utils::parallel_format(fileno(fp), rec.begin(), rec.end(), func, utils::parallel_config(3, 64));
+		res.clear();
+		if(ok) {
+			rewind(fp);
+			char tmp[256];
+			size_t n;
+			while((n = fread(tmp, 1, sizeof(tmp), fp)) > 0) {
+				res.append(tmp, n);
+			}
+		}
+		if(fp != nullptr) {
+			fclose(fp);
+		}
+		sub += list_result_(total + 1, 4, num, "parallel format (writev) check. ", "write fail.", !ok || res != ref);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 38)) {  // Test39: 出力の中断、再開の検査
+		int sub = 0;
+		int num = 4;
+		const char* name = "resumable";
+		std::string ref;
+		{
+			char tmp[128];
+			snprintf(tmp, sizeof(tmp), "No.%d: %s, %08X, %6.3f [%s] (1, -2, 3)\n", -1234, name, 0xabcdefu, 3.14159, "0123456789abcdef");
+			ref = tmp;
+		}
+		// 8 バイトのバッファ（7 文字）で、全て出力するまで繰り返す
+		std::string res;
+		format::resume_state st;
+		conv_count_num = 0;
+		int loop = 0;
+		format::error err;
+		do {
+			char buf[8];
+			err = (sformat("No.%d: %s, %08X, %6.3f [%s] %s\n", buf, sizeof(buf), st) % -1234 % name % 0xabcdefu % 3.14159
+				% conv_count{ "0123456789abcdef" } % vec3{ 1, -2, 3 }).get_error();
+			res += buf;
+			++loop;
+		} while(st.pending() && loop < 100);
+		sub += list_result_(total + 1, 1, num, "resume output check. ", ref.c_str(), res.c_str(), err);
+		sub += list_result_(total + 1, 2, num, "resume overflow status check. ", "status fail.",
+			loop != static_cast<int>((ref.size() + 6) / 7));
+		// 16 文字の値は 7 文字毎に３回に分けて出力される（出力済みの値は変換しない）
+		sub += list_result_(total + 1, 3, num, "resume no re-convert check. ", "re-convert fail.", conv_count_num != 3);
+		// 溢れた場合の状態（再開しない場合）
+		{
+			char buf[8];
+			auto e = (sformat("%s", buf, sizeof(buf)) % name).get_error();
+			sub += list_result_(total + 1, 4, num, "overflow status check. ", "overflow fail.",
+				e != format::error::out_overflow || strcmp(buf, "resumab") != 0);
+		}
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 39)) {  // Test40: 溢れた場合の必要なサイズの検査
+		int sub = 0;
+		int num = 5;
+		const char* form = "No.%d: %s, %08X, %6.3f %s\n";
+		char ref[128];
+		auto len = snprintf(ref, sizeof(ref), form, -1234, "required", 0xabcdefu, 3.14159, "(1, -2, 3)");
+		// 溢れた後も最後まで数える
+		char buf[16];
+		auto f = sformat(form, buf, sizeof(buf)) % -1234 % "required" % 0xabcdefu % 3.14159 % vec3{ 1, -2, 3 };
+		sub += list_result_(total + 1, 1, num, "overflow required size check. ", "size fail.",
+			f.get_error() != format::error::out_overflow || f.size() != 15 || f.required_size() != len);
+		sub += list_result_(total + 1, 2, num, "overflow written check. ", "write fail.",
+			strncmp(buf, ref, 15) != 0 || buf[15] != 0);
+		// 必要なサイズで再試行
+		std::vector<char> tmp(f.required_size() + 1);
+		auto g = sformat(form, tmp.data(), tmp.size()) % -1234 % "required" % 0xabcdefu % 3.14159 % vec3{ 1, -2, 3 };
+		sub += list_result_(total + 1, 3, num, "retry output check. ", ref, tmp.data(), g.get_error());
+		sub += list_result_(total + 1, 4, num, "retry required size check. ", "size fail.",
+			g.size() != len || g.required_size() != len);
+		// 以前の式の溢れは、同じバッファに追加する式のエラーにしない
+		{
+			auto e = (sformat(form, buf, sizeof(buf)) % -1234 % "required" % 0xabcdefu % 3.14159 % vec3{ 1, -2, 3 }).get_error();
+			auto h = sformat("", buf, sizeof(buf), true);
+			sub += list_result_(total + 1, 5, num, "overflow per expression check. ", "stale overflow.",
+				e != format::error::out_overflow || h.get_error() != format::error::none);
+		}
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 40)) {  // Test41: ノンブロッキング出力（リング・バッファ）の検査
+		int sub = 0;
+		int num = 5;
+		typedef utils::basic_format<utils::fd_ring_chaout<1024> > rformat;
+		auto& ch = rformat::chaout();
+		int sv[2] = { -1, -1 };
+		if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0) {
+			fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+			fcntl(sv[1], F_SETFL, fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+			int sz = 4096;
+			setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz));
+		}
+		ch.set(sv[0]);
+		int marks[2] = { 0, 0 };
+		ch.set_mark(768, 256, [](bool high, void* ctx) { ++static_cast<int*>(ctx)[high ? 0 : 1]; }, marks);
+		// 改行で書き込む
+		std::string res;
+		{
+			rformat("No.%d: %s\n") % 1 % "ring";
+			char tmp[64];
+			auto n = read(sv[1], tmp, sizeof(tmp));
+			res.assign(tmp, n > 0 ? n : 0);
+			sub += list_result_(total + 1, 1, num, "fd ring line check. ", "No.1: ring\n", res, ch.wants_write() ? format::error::over : format::error::none);
+		}
+		// 受け側が読まないと、書き込めない分がバッファに残る（捨てない範囲まで）
+		std::string ref;
+		res.clear();
+		for(uint32_t i = 0; i < 100000; ++i) {
+			char line[64];
+			auto len = snprintf(line, sizeof(line), "line %06u: %08X\n", i, i * 7u);
+			if(ch.space() < static_cast<uint32_t>(len)) break;
+			rformat("line %06u: %08X\n") % i % (i * 7u);
+			ref += line;
+		}
+		bool full = ch.wants_write() && marks[0] == 1 && marks[1] == 0;
+		// イベント・ループの代わりに、読み出しと書き込みを交互に行う
+		for(int i = 0; i < 100000 && (ch.wants_write() || res.size() < ref.size()); ++i) {
+			char tmp[512];
+			auto n = read(sv[1], tmp, sizeof(tmp));
+			if(n > 0) res.append(tmp, n);
+			ch.flush();
+		}
+		sub += list_result_(total + 1, 2, num, "fd ring EAGAIN check. ", "queue fail.",
+			!full || res != ref || ch.lost() != 0 || ch.error() != 0);
+		sub += list_result_(total + 1, 3, num, "fd ring mark check. ", "mark fail.", marks[0] != 1 || marks[1] != 1);
+		// バッファが一杯の場合、捨てた文字を数える
+		{
+			format::error err = format::error::none;
+			for(int i = 0; i < 10000 && err == format::error::none; ++i) {
+				err = (rformat("line %06u: %08X\n") % i % (i * 7u)).get_error();
+			}
+			sub += list_result_(total + 1, 4, num, "fd ring overflow check. ", "overflow fail.",
+				err != format::error::out_overflow || ch.lost() == 0 || ch.pending() != 1024);
+		}
+		// 捨てた文字数は clear() まで累積するが、エラーは式毎（空いた後の式は溢れない）
+		{
+			for(int i = 0; i < 100000 && ch.wants_write(); ++i) {
+				char tmp[512];
+				read(sv[1], tmp, sizeof(tmp));
+				ch.flush();
+			}
+			auto lost = ch.lost();
+			auto err = (rformat("No.%d: %s\n") % 2 % "ring").get_error();
+			sub += list_result_(total + 1, 5, num, "fd ring overflow per expression check. ", "stale overflow.",
+				err != format::error::none || lost == 0 || ch.lost() != lost);
+		}
+		ch.set(-1);
+		ch.set_mark(0, 0, nullptr);
+		close(sv[0]);
+		close(sv[1]);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 41)) {  // Test42: フライト・レコーダー出力の検査
+		int sub = 0;
+		int num = 4;
+		typedef utils::basic_format<utils::recorder_chaout<256> > rformat;
+		auto& rec = rformat::chaout();
+		// 書き出した内容を読む
+		auto dump = [](const utils::recorder_chaout<256>& r) {
+			std::string res;
+			int fds[2];
+			if(pipe(fds) != 0) return res;
+			r.dump(fds[1]);
+			close(fds[1]);
+			char tmp[512];
+			ssize_t n;
+			while((n = read(fds[0], tmp, sizeof(tmp))) > 0) res.append(tmp, n);
+			close(fds[0]);
+			return res;
+		};
+		// 保持する最後の文字の、最初の改行の次から
+		auto tail = [](const std::string& all) {
+			if(all.size() <= 256) return all;
+			auto t = all.substr(all.size() - 256);
+			return t.substr(t.find('\n') + 1);
+		};
+		std::string all;
+		rec.clear();
+		for(int i = 0; i < 10; ++i) {
+			rformat("line %03d: %s\n") % i % "recorder";
+			char tmp[64];
+			snprintf(tmp, sizeof(tmp), "line %03d: %s\n", i, "recorder");
+			all += tmp;
+		}
+		sub += list_result_(total + 1, 1, num, "recorder check. ", all, dump(rec), format::error::none);
+		for(int i = 10; i < 100; ++i) {
+			rformat("line %03d: %s\n") % i % "recorder";
+			char tmp[64];
+			snprintf(tmp, sizeof(tmp), "line %03d: %s\n", i, "recorder");
+			all += tmp;
+		}
+		sub += list_result_(total + 1, 2, num, "recorder wrap check. ", tail(all), dump(rec), format::error::none);
+		// BFN を超えるブロック出力
+		{
+			std::string big;
+			for(int i = 0; i < 40; ++i) big += "block " + std::to_string(i) + "\n";
+			rformat("%s") % big;
+			all += big;
+			sub += list_result_(total + 1, 3, num, "recorder block check. ", tail(all), dump(rec), format::error::none);
+		}
+		// abort（assert）で書き出す
+		{
+			std::string res;
+			int fds[2];
+			int status = 0;
+			if(pipe(fds) == 0) {
+				auto pid = fork();
+				if(pid == 0) {
+					close(fds[0]);
+					struct rlimit rl = { 0, 0 };
+					setrlimit(RLIMIT_CORE, &rl);
+					rec.dump_on_signal(fds[1]);
+					rformat("fatal %d\n") % 42;
+					abort();
+				}
+				close(fds[1]);
+				char tmp[512];
+				ssize_t n;
+				while((n = read(fds[0], tmp, sizeof(tmp))) > 0) res.append(tmp, n);
+				close(fds[0]);
+				waitpid(pid, &status, 0);
+			}
+			all += "fatal 42\n";
+			sub += list_result_(total + 1, 4, num, "recorder signal check. ", "dump fail.",
+				res != tail(all) || !WIFSIGNALED(status) || WTERMSIG(status) != SIGABRT);
+		}
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 42)) {  // Test43: コンパイル時の変換（make_format）の検査
+		int sub = 0;
+		int num = 4;
+		// constexpr 変数は、コンパイル時に変換される（エラー、溢れはコンパイル・エラー）
+		static constexpr auto ver = utils::make_format<32>("Ver %d.%02d (%-5s) %08X", 1, 7, "rc", 0xbeefu);
+		static_assert(ver[0] == 'V' && ver[4] == '1' && ver[31] == 0, "make_format: not constant");
+		static constexpr std::array<char, 16> tbl[] = {
+			utils::make_format<16>("%3d:%04o", 8, 8),
+			utils::make_format<16>("[%-6b]", 5),
+			utils::make_format<16>("%.3s|%x", "abcdef", 0xc0deu),
+			utils::make_format<16>("%5.2:8y", 0x180u),
+		};
+		char ref[64];
+		sformat("Ver %d.%02d (%-5s) %08X", ref, sizeof(ref)) % 1 % 7 % "rc" % 0xbeefu;
+		sub += list_result_(total + 1, 1, num, "constexpr version check. ", ref, ver.data(), format::error::none);
+		std::string res;
+		std::string all;
+		const char* form[] = { "%3d:%04o", "[%-6b]", "%.3s|%x", "%5.2:8y" };
+		sformat(form[0], ref, sizeof(ref)) % 8 % 8;
+		all += ref;
+		sformat(form[1], ref, sizeof(ref)) % 5;
+		all += ref;
+		sformat(form[2], ref, sizeof(ref)) % "abcdef" % 0xc0deu;
+		all += ref;
+		sformat(form[3], ref, sizeof(ref)) % 0x180u;
+		all += ref;
+		for(const auto& t : tbl) res += t.data();
+		sub += list_result_(total + 1, 2, num, "constexpr table check. ", all, res, format::error::none);
+		// 実行時に使った場合は、溢れた所までの文字列
+		auto r = utils::make_format<8>("%d", 123456789);
+		sub += list_result_(total + 1, 3, num, "runtime overflow check. ", "1234567", r.data(), format::error::none);
+		utils::array_format<8> f(format::constant, "%d");
+		f % 123456789;
+		sub += list_result_(total + 1, 4, num, "array format required check. ", "size fail.",
+			f.get_error() != format::error::out_overflow || f.size() != 7 || f.required_size() != 9);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 43)) {  // Test44: %y 固定小数点の、引数の幅毎の検査（符号、丸めの桁上がり）
+		int sub = 0;
+		int num = 8;
+		char res[64];
+		sformat("%.3:4y", res, sizeof(res)) % static_cast<uint8_t>(0xff);
+		sub += list_result_(total + 1, 1, num, "uint8_t fixed point check. ", "15.937", res, format::error::none);
+		sformat("%.2:7y", res, sizeof(res)) % static_cast<int8_t>(-128);
+		sub += list_result_(total + 1, 2, num, "int8_t minimum check. ", " -1.00", res, format::error::none);
+		sformat("%5.2:8y", res, sizeof(res)) % static_cast<int16_t>(0x180);
+		sub += list_result_(total + 1, 3, num, "int16_t positive check. ", " 1.50", res, format::error::none);
+		sformat("%.2:8y", res, sizeof(res)) % 0xffffffffu;
+		sub += list_result_(total + 1, 4, num, "uint32_t round carry check. ", "16777216.00", res, format::error::none);
+		sformat("%.1:16y", res, sizeof(res)) % std::numeric_limits<int32_t>::min();
+		sub += list_result_(total + 1, 5, num, "int32_t minimum check. ", "-32768.0", res, format::error::none);
+		sformat("%.4:16y", res, sizeof(res)) % static_cast<uint16_t>(0x8000);
+		sub += list_result_(total + 1, 6, num, "uint16_t fraction only check. ", "0.5000", res, format::error::none);
+		sformat("%5.2:8y", res, sizeof(res)) % static_cast<int64_t>(-0x180);
+		sub += list_result_(total + 1, 7, num, "int64_t negative check. ", "-1.50", res, format::error::none);
+		sformat("%+.2:30y", res, sizeof(res)) % 0x7fffffff;
+		sub += list_result_(total + 1, 8, num, "wide fraction check. ", " +2.00", res, format::error::none);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 44)) {  // Test45: フラッシュ統計の検査
+		int sub = 0;
+		int num = 4;
+		// 標準出力（パイプに付け替える）
+		typedef utils::basic_format<utils::stdout_buffered_chaout<16, utils::flush_stat> > bformat;
+		auto& st = bformat::chaout().stat();
+		st.reset();
+		std::cout.flush();
+		fflush(stdout);
+		int pfd[2] = { -1, -1 };
+		std::string res;
+		if(pipe(pfd) == 0) {
+			int save = dup(STDOUT_FILENO);
+			dup2(pfd[1], STDOUT_FILENO);
+			bformat("ab\n");
+			bformat("%s") % "0123456789abcdefghij";
+			bformat::flush();
+			fflush(stdout);  // USE_PUTCHAR
+			dup2(save, STDOUT_FILENO);
+			close(save);
+			close(pfd[1]);
+			char tmp[64];
+			ssize_t n;
+			while((n = read(pfd[0], tmp, sizeof(tmp))) > 0) res.append(tmp, n);
+		}
+		sub += list_result_(total + 1, 1, num, "buffered output check. ", "ab\n0123456789abcdefghij", res, format::error::none);
+		sub += list_result_(total + 1, 2, num, "buffered flush stat check. ", "count fail.",
+			st.flushes != 3 || st.newline != 1 || st.full != 1 || st.request != 1 || st.writes != 3 ||
+			st.bytes != 23 || st.shorts != 0 || st.errors != 0 || st.hist[1] != 1 || st.hist[2] != 1 || st.hist[4] != 1);
+		// 統計の書き出し
+		res.clear();
+		if(pipe(pfd) == 0) {
+			st.dump(pfd[1]);
+			close(pfd[1]);
+			char tmp[256];
+			ssize_t n;
+			while((n = read(pfd[0], tmp, sizeof(tmp))) > 0) res.append(tmp, n);
+			close(pfd[0]);
+		}
+		sub += list_result_(total + 1, 3, num, "flush stat dump check. ", "dump fail.",
+			res.find("flush: 3 (newline 1, full 1, request 1)\n") != 0 ||
+			res.find("      2 -     3: 1\n") == std::string::npos || res.find("     16 -    31: 1\n") == std::string::npos);
+		// ノンブロッキング（受け側が読まないと、部分書き込み、EAGAIN になる）
+		typedef utils::basic_format<utils::fd_ring_chaout<1024, utils::flush_stat> > rformat;
+		auto& ch = rformat::chaout();
+		int sv[2] = { -1, -1 };
+		if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0) {
+			fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+			fcntl(sv[1], F_SETFL, fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+			int sz = 4096;
+			setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sz, sizeof(sz));
+		}
+		ch.set(sv[0]);
+		for(uint32_t i = 0; i < 100000 && ch.space() >= 20; ++i) {
+			rformat("line %06u: %04X\n") % i % (i & 0xffff);
+		}
+		size_t got = 0;
+		for(int i = 0; i < 100000 && ch.wants_write(); ++i) {
+			char tmp[512];
+			auto n = read(sv[1], tmp, sizeof(tmp));
+			if(n > 0) got += n;
+			ch.flush();
+		}
+		for(int i = 0; i < 100; ++i) {
+			char tmp[512];
+			auto n = read(sv[1], tmp, sizeof(tmp));
+			if(n <= 0) break;
+			got += n;
+		}
+		const auto& rs = ch.stat();
+		sub += list_result_(total + 1, 4, num, "fd ring flush stat check. ", "count fail.",
+			rs.bytes != got || ch.size() != got || rs.errors == 0 || rs.writes < rs.flushes ||
+			rs.flushes != rs.newline + rs.full + rs.request || rs.request == 0);
+		ch.set(-1);
+		close(sv[0]);
+		close(sv[1]);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 45)) {  // Test46: シグナル・ハンドラー用 format の検査
+		int sub = 0;
+		int num = 5;
+		int pfd[2] = { -1, -1 };
+		// 整数、１６進、ポインター、文字列（バッファより長い文字列は直接書き出す）
+		std::string res;
+		std::string ref;
+		const char* longstr = "0123456789abcdefghijklmnopqrstuvwxyz";
+		if(pipe(pfd) == 0) {
+			utils::signal_format(pfd[1], "%d %-4u %x %08X %p '%s'\n") % -42 % 7u % 0xabcu % 0xbeefu % reinterpret_cast<void*>(0x1234) % "str";
+			utils::basic_format<utils::signal_chaout<16> >(pfd[1], "[%s] %d\n") % longstr % 99;
+			close(pfd[1]);
+			res = read_all_(pfd[0]);
+			close(pfd[0]);
+		}
+		{
+			char tmp[128];
+			utils::sformat("%d %-4u %x %08X %p '%s'\n[%s] %d\n", tmp, sizeof(tmp)) % -42 % 7u % 0xabcu % 0xbeefu
+				% reinterpret_cast<void*>(0x1234) % "str" % longstr % 99;
+			ref = tmp;
+		}
+		sub += list_result_(total + 1, 1, num, "signal format check. ", ref, res, format::error::none);
+		// 変換の途中（シグナル・ハンドラー用 format、静的な出力ファンクタの sformat）でシグナル
+		res.clear();
+		char buf[64] = { 0 };
+		if(pipe(pfd) == 0) {
+			sig_fd_ = pfd[1];
+			auto old = std::signal(SIGUSR1, sig_handler_);
+			utils::signal_format(pfd[1], "main %d %s %d\n") % 1 % raise_sig{ SIGUSR1 } % 2;
+			utils::sformat("A%sB%d", buf, sizeof(buf)) % raise_sig{ SIGUSR1 } % 3;
+			std::signal(SIGUSR1, old);
+			sig_fd_ = -1;
+			close(pfd[1]);
+			res = read_all_(pfd[0]);
+			close(pfd[0]);
+		}
+		{
+			char tmp[64];
+			utils::sformat("handler: %5d %08X %p %s\n", tmp, sizeof(tmp)) % -123 % 0xbeefu % reinterpret_cast<void*>(0x1234) % "in handler";
+			ref = std::string(tmp) + "main 1 [] 2\n" + tmp;
+		}
+		sub += list_result_(total + 1, 2, num, "format in signal handler check. ", ref, res, format::error::none);
+		sub += list_result_(total + 1, 3, num, "interrupted sformat check. ", "A[]B3", buf, format::error::none);
+		// 書き出しのエラーで errno を変えない
+		int bad = -1;
+		if(pipe(pfd) == 0) {
+			close(pfd[0]);
+			close(pfd[1]);
+			bad = pfd[1];
+		}
+		errno = 0;
+		utils::signal_format(bad, "%s\n") % "lost";
+		sub += list_result_(total + 1, 4, num, "errno keep check. ", "errno fail.", errno != 0);
+		// 時刻（localtime_r）は変換しない
+		auto tf = utils::signal_format(-1, "%t");
+		tf % static_cast<time_t>(0);
+		sub += list_result_(total + 1, 5, num, "time reject check. ", "error fail.", tf.get_error() != format::error::unknown);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+#ifdef __SIZEOF_INT128__
+	if(exec & (1ull << 46)) {  // Test47: 128 ビット整数の検査
+		int sub = 0;
+		int num = 5;
+		char tmp[256];
+		unsigned __int128 umax = ~static_cast<unsigned __int128>(0);
+		__int128 smax = static_cast<__int128>(umax >> 1);
+		__int128 smin = -smax - 1;
+		auto err = utils::sformat("%u|%d|%d", tmp, sizeof(tmp)) % umax % smax % smin;
+		sub += list_result_(total + 1, 1, num, "int128 decimal check. ",
+			"340282366920938463463374607431768211455|170141183460469231731687303715884105727|"
+			"-170141183460469231731687303715884105728", tmp, err.get_error());
+		// 10^19 の分割境界
+		unsigned __int128 e19 = 10000000000000000000ull;
+		err = utils::sformat("%u|%u|%u|%u", tmp, sizeof(tmp)) % (e19 - 1) % e19 % (e19 * e19 - 1) % (e19 * e19);
+		sub += list_result_(total + 1, 2, num, "int128 chunk boundary check. ",
+			"9999999999999999999|10000000000000000000|99999999999999999999999999999999999999|"
+			"100000000000000000000000000000000000000", tmp, err.get_error());
+		err = utils::sformat("%x|%X|%o|%b", tmp, sizeof(tmp)) % umax % (umax >> 4) % umax % (static_cast<unsigned __int128>(5) << 64);
+		sub += list_result_(total + 1, 3, num, "int128 hex/octal/binary check. ",
+			"ffffffffffffffffffffffffffffffff|FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF|3777777777777777777777777777777777777777777|"
+			"1010000000000000000000000000000000000000000000000000000000000000000", tmp, err.get_error());
+		err = utils::sformat("%+d|%08d|%-6d|%40u|", tmp, sizeof(tmp)) % static_cast<__int128>(42) % static_cast<__int128>(-42)
+			% static_cast<__int128>(7) % (e19 * 123);
+		sub += list_result_(total + 1, 4, num, "int128 width/sign check. ",
+			"+42|-0000042|7     |                  1230000000000000000000|", tmp, err.get_error());
+		std::vector<__int128> v{ 1, -2, smax };
+		err = utils::sformat("%d|%x", tmp, sizeof(tmp)) % v % utils::join(v, "/");
+		sub += list_result_(total + 1, 5, num, "int128 range check. ",
+			"1, -2, 170141183460469231731687303715884105727|1/fffffffffffffffffffffffffffffffe/7fffffffffffffffffffffffffffffff",
+			tmp, err.get_error());
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+#endif
+
+	if(exec & (1ull << 47)) {  // Test48: １６進浮動小数点（%a、%A）の検査
+		int sub = 0;
+		int num = 5;
+		char tmp[256];
+		auto err = utils::sformat("%a|%a|%a|%a|%a|%a", tmp, sizeof(tmp)) % 1.5 % -2.75 % 0.1 % 0.0
+			% std::numeric_limits<double>::max() % std::numeric_limits<double>::denorm_min();
+		sub += list_result_(total + 1, 1, num, "hex real double check. ",
+			"0x1.8p+0|-0x1.6p+1|0x1.999999999999ap-4|0x0p+0|0x1.fffffffffffffp+1023|0x0.0000000000001p-1022", tmp, err.get_error());
+		// float は double と同じ形式（非正規化数は正規化）
+		err = utils::sformat("%a|%a|%A", tmp, sizeof(tmp)) % 0.1f % std::numeric_limits<float>::denorm_min() % 255.5f;
+		sub += list_result_(total + 1, 2, num, "hex real float check. ",
+			"0x1.99999ap-4|0x1p-149|0X1.FFP+7", tmp, err.get_error());
+		err = utils::sformat("%.0a|%.1a|%.3a|%.2a|%.15a", tmp, sizeof(tmp)) % 1.5 % 0.1 % 1.9999 % 0.1 % 1.5;
+		sub += list_result_(total + 1, 3, num, "hex real precision check. ",
+			"0x2p+0|0x1.ap-4|0x2.000p+0|0x1.9ap-4|0x1.800000000000000p+0", tmp, err.get_error());
+		err = utils::sformat("%+020.2a|%-12a|%12a|%020a", tmp, sizeof(tmp)) % 1.5 % -2.75 % 0.5 % -1.0;
+		sub += list_result_(total + 1, 4, num, "hex real width check. ",
+			"+0x00000000001.80p+0|-0x1.6p+1   |      0x1p-1|-0x00000000000001p+0", tmp, err.get_error());
+		// 文字列から戻した値が、ビット単位で一致する
+		static const double rtv[] = { 3.141592653589793, -1e-310, 6.02214076e23, 1.0 / 3.0, 4.9e-324 };
+		bool rterr = false;
+		for(double v : rtv) {
+			utils::sformat("%a", tmp, sizeof(tmp)) % v;
+			double r = std::strtod(tmp, nullptr);
+			if(std::memcmp(&r, &v, sizeof(v)) != 0) rterr = true;
+		}
+		sub += list_result_(total + 1, 5, num, "hex real round trip check. ", "round trip fail.", rterr);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+#ifdef USE_ESCAPE_FORM
+	if(exec & (1ull << 48)) {  // Test49: 文字列のエスケープ（%js、%vs）の検査
+		int sub = 0;
+		int num = 5;
+		char tmp[256];
+		std::string js = "say \"hi\"\\path\n\t\x01 and a long clean run of text \x1f.";
+		auto err = utils::sformat("{\"k\":\"%js\"}", tmp, sizeof(tmp)) % js;
+		sub += list_result_(total + 1, 1, num, "json escape check. ",
+			"{\"k\":\"say \\\"hi\\\"\\\\path\\n\\t\\u0001 and a long clean run of text \\u001f.\"}", tmp, err.get_error());
+		err = utils::sformat("%vs,%vs,%vs,%vs", tmp, sizeof(tmp)) % "plain" % "a,b" % "say \"hi\"" % std::string_view("x\ny");
+		sub += list_result_(total + 1, 2, num, "csv escape check. ",
+			"plain,\"a,b\",\"say \"\"hi\"\"\",\"x\ny\"", tmp, err.get_error());
+		// 幅はエスケープした後の文字数、精度はエスケープする前の文字数
+		err = utils::sformat("[%-8js][%8vs][%.3js]", tmp, sizeof(tmp)) % "a\"b" % "q\"" % "\"\"\"\"";
+		sub += list_result_(total + 1, 3, num, "escape width check. ",
+			"[a\\\"b    ][   \"q\"\"\"][\\\"\\\"\\\"]", tmp, err.get_error());
+		std::vector<std::string> v{ "a,b", "c", "d\"" };
+		err = utils::sformat("%vs|%js", tmp, sizeof(tmp)) % utils::join(v, ",") % utils::join(v, ",", "[", "]");
+		sub += list_result_(total + 1, 4, num, "escape range check. ",
+			"\"a,b\",c,\"d\"\"\"|[a,b,c,d\\\"]", tmp, err.get_error());
+		// エスケープは %s だけ
+		err = utils::sformat("%jd", tmp, sizeof(tmp)) % 1;
+		sub += list_result_(total + 1, 5, num, "escape conversion check. ", "error type of unknown fail.", err.get_error() != format::error::unknown);
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+#endif
+
+	if(exec & (1ull << 49)) {  // Test50: FILE、std::streambuf への出力（file_format、stream_format）の検査
+		int sub = 0;
+#ifdef USE_STREAM_FORM
+		int num = 8;
+#else
+		int num = 4;
+#endif
+		char tmp[512];
+		// stdio のバッファへ直接書くので、fputs などと順番が保たれる
+		auto fp = tmpfile();
+		std::string fs;
+		if(fp != nullptr) {
+			fputs("a:", fp);
+			utils::file_format(fp, "%d|%5s|%x") % 12 % "xy" % 255u;
+			fprintf(fp, ":%c", 'b');
+			utils::file_format(fp, "%s") % std::string(64, '-');
+			fflush(fp);
+			rewind(fp);
+			auto n = fread(tmp, 1, sizeof(tmp) - 1, fp);
+			tmp[n] = 0;
+			fs = tmp;
+			fclose(fp);
+		}
+		sub += list_result_(total + 1, 1, num, "file order check. ",
+			"a:12|   xy|ff:b" + std::string(64, '-'), fs, format::error::none);
+		{
+			utils::file_format f(static_cast<FILE*>(nullptr), "%d");
+			f % 1234;
+			sub += list_result_(total + 1, 2, num, "file null check. ", "out null fail.",
+				f.size() != 0 || f.get_error() != format::error::out_null);
+		}
+		// 出力ファンクタを自分で持つ format は chaout() を持たない、既定の file_chaout はロックしない
+		{
+			static_assert(!has_static_chaout<utils::file_format>::value, "file_format::chaout() must not exist");
+			static_assert(has_static_chaout<utils::sformat>::value, "sformat::chaout() must exist");
+			utils::file_chaout ch;
+			std::atomic<bool> done(false);
+			std::thread([&done] { fflush(stdout); done = true; }).detach();
+			for(int i = 0; i < 300 && !done; ++i) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+			sub += list_result_(total + 1, 3, num, "file default lock check. ", "stdout locked.", !done || ch.get() != nullptr);
+		}
+		// 書き込めない FILE（バッファ無しの /dev/full）
+		{
+			auto full = fopen("/dev/full", "w");
+			format::error err = format::error::none;
+			uint32_t lost = 0;
+			if(full != nullptr) {
+				setvbuf(full, nullptr, _IONBF, 0);
+				utils::file_format f(full, "%d");
+				f % 1234;
+				err = f.get_error();
+				lost = f.at_chaout().lost();
+			}
+			sub += list_result_(total + 1, 4, num, "file write fail check. ", "lost fail.",
+				err != format::error::out_overflow || lost != 4);
+			if(full != nullptr) fclose(full);
+		}
+#ifdef USE_STREAM_FORM
+		// put 領域へ直接書くので、operator << と順番が保たれる
+		std::ostringstream os;
+		os << "x=";
+		utils::stream_format(os, "%05.1f,%-3d") % 3.14159f % 7;
+		os << '!';
+		utils::stream_format(os.rdbuf(), "%s") % "[end]";
+		sub += list_result_(total + 1, 5, num, "stream order check. ", "x=003.1,7  ![end]", os.str(), format::error::none);
+		// good() で無いストリームには出力しない
+		std::ostringstream bad;
+		bad.setstate(std::ios_base::badbit);
+		{
+			utils::stream_format f(bad, "%d");
+			f % 1;
+			sub += list_result_(total + 1, 6, num, "stream bad check. ", "output fail.",
+				!bad.str().empty() || f.size() != 0 || f.get_error() != format::error::out_null);
+		}
+		// 固定長の put 領域（溢れた文字は sputn が書けなかった文字数で検出）
+		struct fixed_buf : public std::streambuf {
+			char buf[8];
+			fixed_buf() { setp(buf, buf + sizeof(buf)); }
+		};
+		{
+			fixed_buf fb;
+			auto e = (utils::stream_format(&fb, "%s") % "0123456789").get_error();
+			fixed_buf fo;
+			std::ostream fos(&fo);
+			utils::stream_format f(fos, "%s%c");
+			f % "0123456789" % 'z';
+			sub += list_result_(total + 1, 7, num, "stream overflow check. ", "overflow fail.",
+				e != format::error::out_overflow || std::string(fb.buf, 8) != "01234567"
+				|| f.get_error() != format::error::out_overflow || f.at_chaout().lost() != 3 || !fos.bad());
+		}
+		// exceptions() に badbit が有っても、例外は投げない（状態だけ設定）
+		{
+			fixed_buf fo;
+			std::ostream fos(&fo);
+			fos.exceptions(std::ios_base::badbit);
+			auto e = (utils::stream_format(fos, "%s") % "0123456789").get_error();
+			sub += list_result_(total + 1, 8, num, "stream exceptions check. ", "badbit fail.",
+				e != format::error::out_overflow || !fos.bad());
+		}
+#endif
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 50)) {  // Test51: %f の大きな値（2^56 以上）、長い精度の検査
+		int sub = 0;
+		static const char* form[] = { "%f", "%.3f", "%.0f", "%30.2f", "%.40f" };
+		static const float val[] = { 1e15f, 1e16f, 1e17f, 1e18f, 2e18f, -2.8e18f, 1e19f, 1e20f, 3.4e38f, 0.1f };
+		static constexpr int fn = sizeof(form) / sizeof(form[0]);
+		int num = fn * (sizeof(val) / sizeof(val[0]));
+		for(int i = 0; i < num; ++i) {
+			auto a = val[i / fn];
+			char ref[128];
+			sprintf(ref, form[i % fn], a);
+			char res[128];
+			auto err = (sformat(form[i % fn], res, sizeof(res)) % a).get_error();
+			sub += list_result_(total + 1, i + 1, num, "large fixed real check. ", ref, res, err);
+		}
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
+	if(exec & (1ull << 51)) {  // Test52: 出力ファンクタを自分で持つ format での、ユーザー型の検査
+		int sub = 0;
+#ifdef USE_STREAM_FORM
+		int num = 6;
+#else
+		int num = 5;
+#endif
+		const vec3 v{ 1, -2, 3 };
+		const char* ref = "v=(1, -2, 3);";
+		{
+			utils::array_format<32> f(format::constant, "v=%s;");
+			f % v;
+			sub += list_result_(total + 1, 1, num, "array format user check. ", ref, f.at_chaout().c_str(), f.get_error());
+		}
+		{
+			auto r = utils::make_format<32>("v=%s;", v);
+			sub += list_result_(total + 1, 2, num, "make format user check. ", ref, r.data(), format::error::none);
+		}
+		// 入れ子の format で溢れた場合も、外側の format のエラーになる
+		{
+			utils::array_format<8> f(format::constant, "%s");
+			f % v;
+			sub += list_result_(total + 1, 3, num, "array format user overflow check. ", "overflow fail.",
+				f.get_error() != format::error::out_overflow || f.required_size() != 10);
+		}
+		{
+			std::string res;
+			int pfd[2];
+			if(pipe(pfd) == 0) {
+				utils::signal_format(pfd[1], "v=%s;") % v;
+				char tmp[64];
+				auto n = read(pfd[0], tmp, sizeof(tmp));
+				res.assign(tmp, n > 0 ? n : 0);
+				close(pfd[0]);
+				close(pfd[1]);
+			}
+			sub += list_result_(total + 1, 4, num, "signal format user check. ", ref, res, format::error::none);
+		}
+		{
+			std::string res;
+			auto fp = tmpfile();
+			if(fp != nullptr) {
+				utils::file_format(fp, "v=%s;") % v;
+				fflush(fp);
+				rewind(fp);
+				char tmp[64];
+				auto n = fread(tmp, 1, sizeof(tmp) - 1, fp);
+				res.assign(tmp, n);
+				fclose(fp);
+			}
+			sub += list_result_(total + 1, 5, num, "file format user check. ", ref, res, format::error::none);
+		}
+#ifdef USE_STREAM_FORM
+		{
+			std::ostringstream os;
+			utils::stream_format(os, "v=%s;") % v;
+			sub += list_result_(total + 1, 6, num, "stream format user check. ", ref, os.str(), format::error::none);
+		}
+#endif
+		if(sub == num) {
+			++pass;
+		}
+		++total;
+	}
+
 	std::cout << std::endl;
 	std::cout << "format class Version: " << format::VERSION << std::endl;
 	if(pass == total) {
@@ -0,0 +1,26 @@
+//=============================================================================//
+/*! @file
+    @brief  utils::null_format のコードサイズ検査 @n
+			・null_format を使った関数と、空の関数（NULL_REF 定義時）を、同じ最適化で @n
+			コンパイルし、text サイズが同じである事を確認する（make null_check）
+    @author 平松邦仁 (hira@rvf-rc45.net)
+	@copyright	Copyright (C) 2026 Kunihito Hiramatsu @n
+				Released under the MIT license @n
+				https://github.com/hirakuni45/RX/blob/master/LICENSE
+*/
+//=============================================================================//
+#include "format.hpp"
+
+void null_site(int a, unsigned b, float c, const char* s, const std::string& str, void* p);
+
+void null_site(int a, unsigned b, float c, const char* s, const std::string& str, void* p)
+{
+#ifndef NULL_REF
+	utils::null_format("%d, %u, %f, %s, %s, %p\n") % a % b % c % s % str % p;
+	utils::null_format("%-8s: %08X, %e, %g\n") % "literal" % b % c % 1.5;
+	auto err = (utils::null_format("%d\n") % a).get_error();
+	if(err != utils::null_format::error::none) {
+		utils::null_format("error\n");
+	}
+#endif
+}